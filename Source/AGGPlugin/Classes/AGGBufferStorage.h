@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+// Pool of 64-byte aligned byte blocks shared by render buffers. Block
+// capacities are rounded up to whole pages. A released block is reused for
+// requests it fits within MaxSlack, so buffers that are resized frequently
+// reuse released memory without wasting more than a fraction of it.
+
+class AGGPLUGIN_API FAGGBufferPool
+{
+public:
+
+    enum { Alignment = 64 };
+    enum { PageSize = 4096 };
+
+    // Reused blocks may exceed the requested capacity by 1/MaxSlack
+    enum { MaxSlack = 4 };
+
+    static FAGGBufferPool& Get();
+
+    ~FAGGBufferPool();
+
+    uint8* Allocate(SIZE_T Size, SIZE_T& OutCapacity);
+    void Release(uint8* Data, SIZE_T Capacity);
+
+    // Frees all pooled blocks, also called on memory trim requests
+    void Trim();
+
+    FORCEINLINE void SetMaxPooledBytes(SIZE_T InMaxPooledBytes)
+    {
+        MaxPooledBytes = InMaxPooledBytes;
+    }
+
+    FORCEINLINE SIZE_T GetPooledBytes() const
+    {
+        return PooledBytes;
+    }
+
+    FORCEINLINE static SIZE_T GetCapacity(SIZE_T Size)
+    {
+        return Align(FMath::Max<SIZE_T>(Size, 1), PageSize);
+    }
+
+private:
+
+    FCriticalSection PoolLock;
+    TMap<SIZE_T, TArray<uint8*>> Buckets;
+    SIZE_T PooledBytes = 0;
+    SIZE_T MaxPooledBytes = 64*1024*1024;
+};
+
+// Owned aligned byte storage backed by FAGGBufferPool
+
+class AGGPLUGIN_API FAGGBufferStorage
+{
+public:
+
+    FAGGBufferStorage() = default;
+
+    ~FAGGBufferStorage()
+    {
+        Release();
+    }
+
+    // Returns storage of at least the specified size, reusing the current
+    // block if it is large enough and not more than twice the required
+    // capacity. Content is left uninitialized.
+    uint8* Allocate(SIZE_T InSize)
+    {
+        if (InSize > Capacity || FAGGBufferPool::GetCapacity(InSize) < Capacity/2)
+        {
+            Release();
+            Data = FAGGBufferPool::Get().Allocate(InSize, Capacity);
+        }
+
+        Size = InSize;
+
+        return Data;
+    }
+
+    void Release()
+    {
+        if (Data)
+        {
+            FAGGBufferPool::Get().Release(Data, Capacity);
+            Data = nullptr;
+        }
+
+        Size = 0;
+        Capacity = 0;
+    }
+
+    FORCEINLINE uint8* GetData()
+    {
+        return Data;
+    }
+
+    FORCEINLINE const uint8* GetData() const
+    {
+        return Data;
+    }
+
+    FORCEINLINE SIZE_T Num() const
+    {
+        return Size;
+    }
+
+private:
+
+    uint8* Data = nullptr;
+    SIZE_T Size = 0;
+    SIZE_T Capacity = 0;
+
+    // Non-Copyable
+    FAGGBufferStorage(const FAGGBufferStorage&) = delete;
+    const FAGGBufferStorage& operator=(const FAGGBufferStorage&) = delete;
+};
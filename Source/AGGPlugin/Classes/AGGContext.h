@@ -29,13 +29,17 @@
 
 #include "CoreUObject.h"
 #include "SharedPointer.h"
+#include "ThreadSafeCounter.h"
 #include "Engine/Texture2D.h"
 
 #include "AGGTypes.h"
 #include "AGGPathController.h"
 #include "AGGRenderBuffer.h"
+#include "AGGRenderJob.h"
 #include "AGGContext.generated.h"
 
+DECLARE_DYNAMIC_DELEGATE_OneParam(FAGGRenderJobDelegate, FAGGRenderJobHandle, JobHandle);
+
 USTRUCT(BlueprintType)
 struct AGGPLUGIN_API FAGGByteBufferRef
 {
@@ -80,11 +84,16 @@ public:
 
     virtual void ClearContext()
     {
+        WaitAllRenderJobs();
+        ++BufferGeneration;
+
         if (PathController)
         {
             PathController->Clear();
             PathController = nullptr;
         }
+
+        OutputTexture = nullptr;
     }
 
     virtual void InitBuffer(int32 w, int32 h, int32 c, bool bSq)
@@ -97,11 +106,48 @@ public:
     virtual void RenderContext()
         PURE_VIRTUAL(UAGGContext::RenderContext, );
 
+    virtual IAGGRenderBuffer* GetBufferAt(int32 Index)
+        PURE_VIRTUAL(UAGGContext::GetBufferAt, return nullptr;);
+
+    virtual const IAGGRenderBuffer* GetBufferAt(int32 Index) const
+        PURE_VIRTUAL(UAGGContext::GetBufferAt, return nullptr;);
+
+    // Front buffer, holds the last presented frame if double buffered.
+    // Direct callers have to wait for pending render jobs before accessing
+    // buffer memory.
     virtual IAGGRenderBuffer* GetBuffer()
-        PURE_VIRTUAL(UAGGContext::GetBuffer, return nullptr;);
+    {
+        return GetBufferAt(FrontBufferIndex.GetValue());
+    }
 
     virtual const IAGGRenderBuffer* GetBuffer() const
-        PURE_VIRTUAL(UAGGContext::GetBuffer, return nullptr;);
+    {
+        return GetBufferAt(FrontBufferIndex.GetValue());
+    }
+
+    // Buffer renderers write to, the back buffer if double buffered
+    FORCEINLINE IAGGRenderBuffer* GetRenderBuffer()
+    {
+        return GetBufferAt(GetRenderBufferIndex());
+    }
+
+    FORCEINLINE const IAGGRenderBuffer* GetRenderBuffer() const
+    {
+        return GetBufferAt(GetRenderBufferIndex());
+    }
+
+    FORCEINLINE int32 GetRenderBufferIndex() const
+    {
+        const int32 FrontIndex = FrontBufferIndex.GetValue();
+        return bDoubleBuffered ? 1-FrontIndex : FrontIndex;
+    }
+
+    // Incremented whenever the buffer returned by GetRenderBuffer() changes
+    // or is re-allocated. Renderer objects re-attach on mismatch.
+    FORCEINLINE int32 GetBufferGeneration() const
+    {
+        return BufferGeneration;
+    }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
     virtual EPixelFormat GetPixelFormat() const
@@ -133,6 +179,7 @@ public:
     {
         if (HasValidBuffer())
         {
+            WaitFrontBufferJobs();
             return GetBuffer()->GetByteAt(X, Y);
         }
         return 0;
@@ -140,13 +187,215 @@ public:
 
     FORCEINLINE uint8 GetByteAtUnsafe(int32 X, int32 Y) const
     {
+        WaitFrontBufferJobs();
         return GetBuffer()->GetByteAt(X, Y);
     }
 
+    FORCEINLINE bool HasValidRenderBuffer() const
+    {
+        if (const IAGGRenderBuffer* b = GetRenderBuffer())
+        {
+            return b->IsValid();
+        }
+        return false;
+    }
+
     // END UAGGContext Interface
 
+    // Double Buffering
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool IsDoubleBuffered() const
+    {
+        return bDoubleBuffered;
+    }
+
+    // Enables separate front and back buffers. The back buffer is initialized
+    // with a copy of the front buffer.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void SetDoubleBuffered(bool bInDoubleBuffered)
+    {
+        if (bDoubleBuffered == bInDoubleBuffered)
+        {
+            return;
+        }
+
+        WaitAllRenderJobs();
+
+        const int32 FrontIndex = FrontBufferIndex.GetValue();
+        IAGGRenderBuffer* FrontBuffer = GetBufferAt(FrontIndex);
+        IAGGRenderBuffer* BackBuffer = GetBufferAt(1-FrontIndex);
+
+        if (! FrontBuffer || ! BackBuffer)
+        {
+            return;
+        }
+
+        if (bInDoubleBuffered)
+        {
+            if (FrontBuffer->IsValid())
+            {
+                BackBuffer->Init(FrontBuffer->GetWidth(), FrontBuffer->GetHeight());
+                BackBuffer->CopyFrom(*FrontBuffer);
+                BackBuffer->ClearDirtyRect();
+            }
+        }
+        else
+        {
+            BackBuffer->Reset();
+        }
+
+        bDoubleBuffered = bInDoubleBuffered;
+        SwapDirtyRect.Reset();
+        ++BufferGeneration;
+    }
+
+    // Waits for pending render jobs and presents the back buffer. Renderer
+    // objects attached to the context follow the swap on their next render,
+    // so front buffer readers on the game thread never see a partial frame.
+    // Without bCopyToBackBuffer the new back buffer holds the frame before
+    // the presented one.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void SwapBuffers(bool bCopyToBackBuffer = false)
+    {
+        if (! bDoubleBuffered)
+        {
+            return;
+        }
+
+        WaitAllRenderJobs();
+
+        IAGGRenderBuffer* FrontBuffer = GetRenderBuffer();
+        IAGGRenderBuffer* BackBuffer = GetBuffer();
+
+        FrontBufferIndex.Set(GetRenderBufferIndex());
+        ++BufferGeneration;
+
+        if (! FrontBuffer || ! FrontBuffer->IsValid() || ! BackBuffer)
+        {
+            return;
+        }
+
+        // Output textures hold the previous front buffer, which differs from
+        // the new one by the regions rendered into either buffer since the
+        // previous swap plus its own pending upload
+        FAGGDirtyRect RenderedRect;
+
+        if (FrontBuffer->HasDirtyRect())
+        {
+            const FIntRect& Rect( FrontBuffer->GetDirtyRect() );
+            RenderedRect.Add(Rect.Min.X, Rect.Min.Y, Rect.Max.X-1, Rect.Max.Y-1);
+        }
+
+        FrontBuffer->AddDirtyRect(SwapDirtyRect);
+
+        if (BackBuffer->HasDirtyRect())
+        {
+            const FIntRect& Rect( BackBuffer->GetDirtyRect() );
+            FrontBuffer->AddDirtyRect(Rect.Min.X, Rect.Min.Y, Rect.Max.X-1, Rect.Max.Y-1);
+        }
+
+        if (bCopyToBackBuffer)
+        {
+            BackBuffer->CopyFrom(*FrontBuffer);
+            SwapDirtyRect.Reset();
+        }
+        else
+        {
+            SwapDirtyRect = RenderedRect;
+        }
+
+        BackBuffer->ClearDirtyRect();
+    }
+
+    // Async Render Jobs
+
+    // Launches rasterization of a draw list copy on a worker thread. The
+    // buffer must not be accessed until the job is complete, buffer access
+    // through the context and attached renderers waits for pending jobs.
+    // The job dirty rect is merged into the buffer once the job finishes.
+    FAGGRenderJobHandle LaunchRenderJob(const FAGGDrawList& DrawList, bool bSortByState, const FAGGRenderJobDelegate& OnComplete, EAsyncExecution Execution = EAsyncExecution::ThreadPool)
+    {
+        FAGGRenderJobHandle Handle;
+
+        if (! HasValidRenderBuffer() || GetRenderBuffer()->IsTextureAttached())
+        {
+            return Handle;
+        }
+
+        Handle.JobId = NextRenderJobId++;
+
+        TWeakObjectPtr<UAGGContext> WeakContext(this);
+
+        FAGGRenderJob::FOnComplete OnJobComplete(
+            [WeakContext](int32 JobId)
+            {
+                AsyncTask(ENamedThreads::GameThread, [WeakContext, JobId]()
+                {
+                    if (UAGGContext* Context = WeakContext.Get())
+                    {
+                        Context->FinishRenderJob(JobId);
+                    }
+                } );
+            } );
+
+        FPendingRenderJob& PendingJob( PendingRenderJobs.Emplace(Handle.JobId) );
+        PendingJob.OnComplete = OnComplete;
+        PendingJob.Job = FAGGRenderJob::Launch(
+            Handle.JobId,
+            *GetRenderBuffer(),
+            GetAGGPixFmt(),
+            DrawList,
+            bSortByState,
+            RenderJobLock,
+            MoveTemp(OnJobComplete),
+            Execution
+            );
+
+        return Handle;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool IsRenderJobComplete(FAGGRenderJobHandle JobHandle) const
+    {
+        const FPendingRenderJob* PendingJob = PendingRenderJobs.Find(JobHandle.JobId);
+        return PendingJob ? PendingJob->Job->IsComplete() : true;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool HasPendingRenderJobs() const
+    {
+        return PendingRenderJobs.Num() > 0;
+    }
+
+    // Blocks until the job is complete and fires its completion delegate
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void WaitRenderJob(FAGGRenderJobHandle JobHandle)
+    {
+        if (FPendingRenderJob* PendingJob = PendingRenderJobs.Find(JobHandle.JobId))
+        {
+            PendingJob->Job->Wait();
+            FinishRenderJob(JobHandle.JobId);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void WaitAllRenderJobs()
+    {
+        TArray<int32> JobIds;
+        PendingRenderJobs.GetKeys(JobIds);
+
+        for (int32 JobId : JobIds)
+        {
+            FAGGRenderJobHandle JobHandle;
+            JobHandle.JobId = JobId;
+            WaitRenderJob(JobHandle);
+        }
+    }
+
     FORCEINLINE int32 GetBufferSize()
     {
+        WaitFrontBufferJobs();
         return GetBuffer()->GetBufferSize();
     }
 
@@ -200,16 +449,33 @@ public:
         return GetByteAtUnsafe(X, Y);
     }
 
-    UFUNCTION(BlueprintCallable, BlueprintPure, Category="AGG")
-    const TArray<uint8>& GetByteBuffer() const
+    // Returns a copy of the packed pixel data. Not pure so Blueprint copies
+    // once per call, CopyByteBuffer() reuses the target array allocation.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    TArray<uint8> GetByteBuffer() const
     {
-        return GetBuffer()->GetByteBuffer();
+        TArray<uint8> ByteBuffer;
+        WaitFrontBufferJobs();
+        GetBuffer()->GetByteBuffer(ByteBuffer);
+        return ByteBuffer;
     }
 
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="AGG")
     void CopyByteBuffer(FAGGByteBufferRef& ByteBufferRef) const
     {
-        ByteBufferRef.ByteBuffer = GetBuffer()->GetByteBuffer();
+        WaitFrontBufferJobs();
+        GetBuffer()->GetByteBuffer(ByteBufferRef.ByteBuffer);
+    }
+
+    // Packed pixel data without a copy if the buffer rows are packed,
+    // the view is invalidated by any buffer modification
+    TArrayView<const uint8> GetByteBufferView(TArray<uint8>& Scratch) const
+    {
+        WaitFrontBufferJobs();
+
+        return HasValidBuffer()
+            ? GetBuffer()->GetPackedView(Scratch)
+            : TArrayView<const uint8>();
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
@@ -226,6 +492,8 @@ public:
             return nullptr;
         }
 
+        WaitFrontBufferJobs();
+
         IAGGRenderBuffer& Buffer( *GetBuffer() );
 
         // Generates transient texture
@@ -250,6 +518,8 @@ public:
             return nullptr;
         }
 
+        WaitFrontBufferJobs();
+
         IAGGRenderBuffer& Buffer( *GetBuffer() );
 
         // Generates transient texture
@@ -267,12 +537,103 @@ public:
         return texture;
     }
 
+    // Attaches the render buffer to the texture mip memory so renderers
+    // write into it directly. The texture mip stays locked until
+    // EndTextureRender(), call both within the same frame. C++ callers should
+    // prefer FAGGTextureRenderScope.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool BeginTextureRender(UTexture2D* Texture)
+    {
+        WaitAllRenderJobs();
+
+        if (IsValid(Texture) && GetRenderBuffer())
+        {
+            if (Texture->GetPixelFormat() == GetPixelFormat())
+            {
+                ++BufferGeneration;
+                return GetRenderBuffer()->AttachTexture(Texture);
+            }
+        }
+        return false;
+    }
+
+    // Releases the texture mip memory, updates the texture resource and
+    // restores the previous buffer.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void EndTextureRender(UTexture2D* Texture)
+    {
+        WaitAllRenderJobs();
+
+        if (IAGGRenderBuffer* Buffer = GetRenderBuffer())
+        {
+            if (Buffer->IsTextureAttached())
+            {
+                Buffer->DetachTexture();
+                ++BufferGeneration;
+
+                if (IsValid(Texture))
+                {
+                    Texture->UpdateResource();
+                }
+            }
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="AGG")
+    UTexture2D* GetOutputTexture() const
+    {
+        return OutputTexture;
+    }
+
+    // Updates and returns the cached output texture. The texture is only
+    // re-created when the buffer dimension or pixel format changes, otherwise
+    // only the buffer dirty region is streamed to the texture resource.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    UTexture2D* UpdateOutputTexture(TextureFilter FilterType = TextureFilter::TF_Default, bool bSRGB = false)
+    {
+        if (! HasValidBuffer())
+        {
+            return nullptr;
+        }
+
+        WaitFrontBufferJobs();
+
+        IAGGRenderBuffer& Buffer( *GetBuffer() );
+
+        const bool bRecreate = ! IsValid(OutputTexture)
+            || OutputTexture->GetSizeX() != Buffer.GetWidth()
+            || OutputTexture->GetSizeY() != Buffer.GetHeight()
+            || OutputTexture->GetPixelFormat() != GetPixelFormat();
+
+        if (bRecreate)
+        {
+            OutputTexture = CreateTextureWithFilterType(FilterType, bSRGB);
+            Buffer.ClearDirtyRect();
+        }
+        else
+        if (OutputTexture->Filter != FilterType || OutputTexture->SRGB != (bSRGB ? 1 : 0))
+        {
+            // Texture settings require full resource update
+            OutputTexture->Filter = FilterType;
+            OutputTexture->SRGB = bSRGB ? 1 : 0;
+            CopyToTexture(OutputTexture);
+        }
+        else
+        {
+            Buffer.UpdateTextureRegion(OutputTexture);
+        }
+
+        return OutputTexture;
+    }
+
     UFUNCTION(BlueprintCallable, Category="AGG")
     void CopyFromByteBuffer(const TArray<uint8>& ByteBuffer)
     {
-        if (HasValidBuffer())
+        WaitAllRenderJobs();
+
+        if (HasValidRenderBuffer())
         {
-            IAGGRenderBuffer& Buffer( *GetBuffer() );
+            IAGGRenderBuffer& Buffer( *GetRenderBuffer() );
 
             // Copy buffer if size matches
             if (Buffer.GetBufferSize() == ByteBuffer.Num())
@@ -285,9 +646,11 @@ public:
     UFUNCTION(BlueprintCallable, Category="AGG")
     void CopyFromTexture(UTexture2D* Texture)
     {
-        if (IsValid(Texture) && HasValidBuffer())
+        WaitAllRenderJobs();
+
+        if (IsValid(Texture) && HasValidRenderBuffer())
         {
-            GetBuffer()->CopyFrom(Texture);
+            GetRenderBuffer()->CopyFrom(Texture);
         }
     }
 
@@ -296,11 +659,26 @@ public:
     {
         if (IsValid(Texture) && HasValidBuffer())
         {
+            WaitFrontBufferJobs();
             GetBuffer()->CopyTo(Texture);
+            GetBuffer()->ClearDirtyRect();
             Texture->UpdateResource();
         }
     }
 
+    // Uploads pixels modified since the last upload to the texture resource.
+    // Texture must match the buffer dimension and have an initialized resource.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool UpdateTextureDirtyRegion(UTexture2D* Texture)
+    {
+        if (IsValid(Texture) && HasValidBuffer())
+        {
+            WaitFrontBufferJobs();
+            return GetBuffer()->UpdateTextureRegion(Texture);
+        }
+        return false;
+    }
+
     UFUNCTION(BlueprintCallable, Category="AGG")
     virtual void CopyAlphaFromBuffer(const TArray<uint8>& AlphaBuffer)
     {
@@ -311,4 +689,89 @@ protected:
 	UPROPERTY(Transient)
     UAGGPathController* PathController;
 
+    struct FPendingRenderJob
+    {
+        FAGGRenderJob::FJobPtr Job;
+        FAGGRenderJobDelegate OnComplete;
+    };
+
+    TMap<int32, FPendingRenderJob> PendingRenderJobs;
+    FCriticalSection RenderJobLock;
+    int32 NextRenderJobId = 0;
+
+    // Jobs always write the render buffer, the front buffer is only shared
+    // with them if not double buffered
+    FORCEINLINE void WaitFrontBufferJobs() const
+    {
+        if (! bDoubleBuffered && PendingRenderJobs.Num() > 0)
+        {
+            const_cast<UAGGContext*>(this)->WaitAllRenderJobs();
+        }
+    }
+
+    void FinishRenderJob(int32 JobId)
+    {
+        FPendingRenderJob PendingJob;
+
+        if (PendingRenderJobs.RemoveAndCopyValue(JobId, PendingJob))
+        {
+            PendingJob.Job->MergeDirtyRect();
+
+            FAGGRenderJobHandle JobHandle;
+            JobHandle.JobId = JobId;
+            PendingJob.OnComplete.ExecuteIfBound(JobHandle);
+        }
+    }
+
+	UPROPERTY(Transient)
+    UTexture2D* OutputTexture = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AGG")
+    bool bDoubleBuffered = false;
+
+    FThreadSafeCounter FrontBufferIndex;
+    int32 BufferGeneration = 0;
+
+    // Regions rendered into the front buffer during the frame before the
+    // last swap, the back buffer still differs from it by these regions
+    FAGGDirtyRect SwapDirtyRect;
+
+};
+
+// Renders into texture mip memory for the lifetime of the scope, the
+// previous context buffer is restored on scope exit
+
+class FAGGTextureRenderScope
+{
+public:
+
+    FAGGTextureRenderScope(UAGGContext* InContext, UTexture2D* InTexture)
+        : Context(InContext)
+        , Texture(InTexture)
+    {
+        bAttached = IsValid(Context) && Context->BeginTextureRender(Texture);
+    }
+
+    ~FAGGTextureRenderScope()
+    {
+        if (bAttached && IsValid(Context))
+        {
+            Context->EndTextureRender(Texture);
+        }
+    }
+
+    FORCEINLINE bool IsAttached() const
+    {
+        return bAttached;
+    }
+
+private:
+
+    UAGGContext* Context;
+    UTexture2D* Texture;
+    bool bAttached;
+
+    // Non-Copyable
+    FAGGTextureRenderScope(const FAGGTextureRenderScope&) = delete;
+    const FAGGTextureRenderScope& operator=(const FAGGTextureRenderScope&) = delete;
 };
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "SharedPointer.h"
+
+#include "AGGShapeCache.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Versioned binary file of serialized shape cache coverage. Loaded files are
+// memory-mapped where supported, coverage entries are views into the mapped
+// data and are replayed without copying. Scanline streams are validated once
+// on load. Entry views are allocated in a single array owned by the file and
+// share its reference count.
+
+class AGGPLUGIN_API FAGGCoverageFile : public TSharedFromThis<FAGGCoverageFile, ESPMode::ThreadSafe>
+{
+public:
+
+    enum { FileMagic = 0x43474741 }; // AGGC
+    enum { FileVersion = 2 };
+    enum { DataAlignment = 16 };
+
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 EntryCount;
+        uint32 Flags;
+    };
+
+    struct FEntry
+    {
+        uint64 KeyHash;
+        int32 KeyNumVertices;
+        int32 MinX;
+        int32 MinY;
+        int32 MaxX;
+        int32 MaxY;
+        uint32 KeyCrc;
+        uint64 DataOffset;
+        uint64 DataSize;
+    };
+
+    typedef TSharedPtr<FAGGCoverageFile, ESPMode::ThreadSafe> FFilePtr;
+
+    ~FAGGCoverageFile();
+
+    // Writes all non-empty cache entries
+    static bool Save(const FString& Filename, const FAGGShapeCache& Cache);
+
+    static FFilePtr Load(const FString& Filename);
+
+    FORCEINLINE int32 Num() const
+    {
+        return EntryCount;
+    }
+
+    FORCEINLINE bool IsMapped() const
+    {
+        return MappedRegion != nullptr;
+    }
+
+    FAGGShapeCache::FKey GetKey(int32 Index) const;
+
+    // Coverage view of the entry, the view keeps the file alive
+    FAGGShapeCache::FCoveragePtr GetCoverage(int32 Index) const;
+
+    void AddToCache(FAGGShapeCache& Cache) const;
+
+private:
+
+    IMappedFileHandle* MappedHandle = nullptr;
+    IMappedFileRegion* MappedRegion = nullptr;
+    TArray<uint8> FileData;
+
+    const uint8* Data = nullptr;
+    int64 DataSize = 0;
+    const FEntry* Entries = nullptr;
+    int32 EntryCount = 0;
+    TArray<FAGGCoverage> Coverages;
+
+    FAGGCoverageFile() = default;
+
+    bool Parse(const uint8* InData, int64 InDataSize);
+
+    // Walks the serialized scanlines, returns false if any span header or
+    // cover run exceeds the entry data
+    static bool ValidateCoverage(const uint8* InData, int64 InDataSize);
+
+    // Non-Copyable
+    FAGGCoverageFile(const FAGGCoverageFile&) = delete;
+    const FAGGCoverageFile& operator=(const FAGGCoverageFile&) = delete;
+};
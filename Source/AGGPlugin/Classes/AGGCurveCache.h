@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "SharedPointer.h"
+
+// Cache of flattened curve segments shared by curve conversion stages.
+// Segments are keyed by control points, approximation method, angle
+// tolerance and a quantized approximation scale, so static curves are only
+// subdivided once per zoom step. Eviction keeps two generations, entries not
+// touched since the previous generation rolled over are dropped.
+
+class AGGPLUGIN_API FAGGCurveCache
+{
+public:
+
+    // Approximation scale steps per octave
+    enum { ScaleStepsPerOctave = 8 };
+
+    struct FKey
+    {
+        double Coords[8];
+        int32 ScaleStep;
+        float AngleTolerance;
+        uint8 Method;
+        uint8 NumCoords;
+        uint8 Padding[6];
+
+        FKey()
+        {
+            FMemory::Memzero(*this);
+        }
+
+        FORCEINLINE bool operator==(const FKey& Other) const
+        {
+            return FMemory::Memcmp(this, &Other, sizeof(FKey)) == 0;
+        }
+
+        friend FORCEINLINE uint32 GetTypeHash(const FKey& Key)
+        {
+            return FCrc::MemCrc32(&Key, sizeof(FKey));
+        }
+    };
+
+    // Flattened points after the curve start, interleaved xy
+    typedef TArray<double> FSegment;
+    typedef TSharedPtr<const FSegment, ESPMode::ThreadSafe> FSegmentRef;
+
+    static FAGGCurveCache& Get();
+
+    // Rounds the scale up to the next cached step
+    static int32 GetScaleStep(double Scale)
+    {
+        const double Log2 = FMath::Log2(FMath::Max(Scale, 1e-3));
+        return FMath::CeilToInt(Log2 * ScaleStepsPerOctave - 1e-6);
+    }
+
+    FORCEINLINE static double GetStepScale(int32 ScaleStep)
+    {
+        return FMath::Pow(2.0, double(ScaleStep) / ScaleStepsPerOctave);
+    }
+
+    FSegmentRef Find(const FKey& Key);
+    void Add(const FKey& Key, const FSegmentRef& Segment);
+
+    // Frees all cached segments
+    void Empty();
+
+    FORCEINLINE void SetMaxEntries(int32 InMaxEntries)
+    {
+        MaxEntries = FMath::Max(1, InMaxEntries);
+    }
+
+    FORCEINLINE int32 Num() const
+    {
+        return Current.Num() + Previous.Num();
+    }
+
+private:
+
+    FCriticalSection CacheLock;
+    TMap<FKey, FSegmentRef> Current;
+    TMap<FKey, FSegmentRef> Previous;
+    int32 MaxEntries = 8192;
+};
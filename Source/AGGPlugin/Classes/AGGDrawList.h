@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_path_storage.h"
+#include "agg_conv_stroke.h"
+#include "agg_bounding_rect.h"
+
+#include "AGGTypes.h"
+#include "AGGPathController.h"
+#include "AGGSpatialGrid.h"
+
+// Compact command buffer of recorded paths. All recorded vertices share a
+// single path storage, each command references its vertices by path id.
+// Command bounds are computed once on record and indexed by a uniform grid
+// for region queries.
+
+class AGGPLUGIN_API FAGGDrawList
+{
+public:
+
+    struct FCommand
+    {
+        uint32 PathId;
+        FColor Color;
+        EAGGScanline ScanlineType;
+        int32 StrokeIndex;
+        FBox2D Bounds;
+
+        FCommand() = default;
+
+        FCommand(uint32 InPathId, FColor InColor, EAGGScanline InScanlineType, int32 InStrokeIndex, const FBox2D& InBounds)
+            : PathId(InPathId)
+            , Color(InColor)
+            , ScanlineType(InScanlineType)
+            , StrokeIndex(InStrokeIndex)
+            , Bounds(InBounds)
+        {
+        }
+
+        FORCEINLINE uint32 GetStateKey() const
+        {
+            return (static_cast<uint32>(ScanlineType) << 24) | static_cast<uint32>(StrokeIndex+1);
+        }
+    };
+
+private:
+
+    agg::path_storage Paths;
+    TArray<FCommand> Commands;
+    TArray<FAGGStrokeSettings> StrokeSettings;
+
+    FAGGSpatialGrid Grid;
+    bool bGridDirty = true;
+
+public:
+
+    FORCEINLINE int32 Num() const
+    {
+        return Commands.Num();
+    }
+
+    FORCEINLINE agg::path_storage& GetPaths()
+    {
+        return Paths;
+    }
+
+    FORCEINLINE const TArray<FCommand>& GetCommands() const
+    {
+        return Commands;
+    }
+
+    FORCEINLINE const TArray<FAGGStrokeSettings>& GetStrokeSettings() const
+    {
+        return StrokeSettings;
+    }
+
+    // Clears recorded commands while keeping allocated storage
+
+    void Reset()
+    {
+        Paths.remove_all();
+        Commands.Reset();
+        StrokeSettings.Reset();
+        Grid.Reset();
+        bGridDirty = true;
+    }
+
+    void AddPath(agg::path_storage& Path, FColor Color, EAGGScanline ScanlineType)
+    {
+        AddCommand(Path, Color, ScanlineType, INDEX_NONE);
+    }
+
+    void AddPath(agg::path_storage& Path, FColor Color, EAGGScanline ScanlineType, const FAGGStrokeSettings& Settings)
+    {
+        AddCommand(Path, Color, ScanlineType, FindOrAddStrokeSettings(Settings));
+    }
+
+    // Command order grouped by render state, relative order of commands
+    // sharing the same state is preserved
+
+    void GetSortedOrder(TArray<int32>& OutOrder) const
+    {
+        OutOrder.Reset(Commands.Num());
+
+        for (int32 i=0; i<Commands.Num(); ++i)
+        {
+            OutOrder.Emplace(i);
+        }
+
+        SortByState(OutOrder);
+    }
+
+    void SortByState(TArray<int32>& InOutOrder) const
+    {
+        const TArray<FCommand>& Cmds( Commands );
+
+        InOutOrder.StableSort( [&Cmds](const int32& i0, const int32& i1) {
+            return Cmds[i0].GetStateKey() < Cmds[i1].GetStateKey();
+        } );
+    }
+
+    // Indices of commands whose bounds intersect the region in recorded
+    // order. The grid is rebuilt on the first query after modification.
+
+    void Query(const FBox2D& Region, TArray<int32>& OutIndices)
+    {
+        if (bGridDirty)
+        {
+            const TArray<FCommand>& Cmds( Commands );
+            Grid.Build(Cmds.Num(), [&Cmds](int32 i) { return Cmds[i].Bounds; });
+            bGridDirty = false;
+        }
+
+        Grid.Query(Region, OutIndices);
+    }
+
+    // Stroke outline extent beyond the path bounds
+    static float GetStrokeExtent(const FAGGStrokeSettings& Settings)
+    {
+        const float HalfWidth = Settings.Width * .5f;
+
+        if (Settings.LineJoin == EAGGLineJoin::MITER_JOIN ||
+            Settings.LineJoin == EAGGLineJoin::MITER_JOIN_REVERT ||
+            Settings.LineJoin == EAGGLineJoin::MITER_JOIN_ROUND)
+        {
+            return HalfWidth * FMath::Max(Settings.MiterLimit, 1.4142136f);
+        }
+
+        return HalfWidth * 1.4142136f;
+    }
+
+    template<class FStroke>
+    static void ApplyStrokeSettings(FStroke& Stroke, const FAGGStrokeSettings& Settings)
+    {
+        FAGGPathConversion::ApplyStrokeSettings(Stroke, Settings);
+    }
+
+private:
+
+    void AddCommand(agg::path_storage& Path, FColor Color, EAGGScanline ScanlineType, int32 StrokeIndex)
+    {
+        if (ScanlineType == EAGGScanline::SL_Unknown)
+        {
+            ScanlineType = EAGGScanline::SL_P8;
+        }
+
+        const uint32 PathId = Paths.start_new_path();
+        Paths.concat_path(Path);
+
+        FBox2D Bounds(ForceInit);
+        double x1, y1, x2, y2;
+
+        if (agg::bounding_rect_single(Paths, PathId, &x1, &y1, &x2, &y2))
+        {
+            const float Extent = StrokeSettings.IsValidIndex(StrokeIndex)
+                ? GetStrokeExtent(StrokeSettings[StrokeIndex])
+                : 0.f;
+
+            Bounds = FBox2D(FVector2D(x1, y1), FVector2D(x2, y2)).ExpandBy(Extent + 1.f);
+        }
+
+        Commands.Emplace(PathId, Color, ScanlineType, StrokeIndex, Bounds);
+        bGridDirty = true;
+    }
+
+    int32 FindOrAddStrokeSettings(const FAGGStrokeSettings& Settings)
+    {
+        for (int32 i=StrokeSettings.Num()-1; i>=0; --i)
+        {
+            const FAGGStrokeSettings& s( StrokeSettings[i] );
+
+            if (s.Width           == Settings.Width           &&
+                s.MiterLimit      == Settings.MiterLimit      &&
+                s.InnerMiterLimit == Settings.InnerMiterLimit &&
+                s.LineCap         == Settings.LineCap         &&
+                s.LineJoin        == Settings.LineJoin        &&
+                s.InnerJoin       == Settings.InnerJoin)
+            {
+                return i;
+            }
+        }
+
+        return StrokeSettings.Add(Settings);
+    }
+};
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreUObject.h"
+#include "UniquePtr.h"
+
+#include "AGGTypes.h"
+#include "AGGContext.h"
+#include "AGGDrawList.h"
+#include "AGGRenderer.h"
+#include "AGGPathController.h"
+#include "AGGDrawListObject.generated.h"
+
+UCLASS(BlueprintType)
+class AGGPLUGIN_API UAGGDrawList : public UObject
+{
+	GENERATED_BODY()
+
+    FAGGDrawList DrawList;
+    TUniquePtr<FAGGDrawListRenderer> Renderer;
+
+public:
+
+    // Groups replayed commands by render state. Commands with different state
+    // may be reordered, only use with non-overlapping or opaque shapes.
+    UPROPERTY(BlueprintReadWrite)
+    bool bSortByState = false;
+
+    FORCEINLINE FAGGDrawList& GetDrawList()
+    {
+        return DrawList;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 Num() const
+    {
+        return DrawList.Num();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Reset()
+    {
+        DrawList.Reset();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void AddPath(UAGGPathController* Path, FColor Color, EAGGScanline ScanlineType = EAGGScanline::SL_P8)
+    {
+        if (IsValid(Path))
+        {
+            DrawList.AddPath(Path->GetRenderPath(), Color, ScanlineType);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void AddStrokePath(UAGGPathController* Path, FColor Color, FAGGStrokeSettings StrokeSettings, EAGGScanline ScanlineType = EAGGScanline::SL_P8)
+    {
+        if (IsValid(Path))
+        {
+            DrawList.AddPath(Path->GetRenderPath(), Color, ScanlineType, StrokeSettings);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Replay(UAGGContext* Context)
+    {
+        if (IsValid(Context) && Context->HasValidRenderBuffer())
+        {
+            Context->WaitAllRenderJobs();
+
+            if (! Renderer.IsValid())
+            {
+                Renderer = MakeUnique<FAGGDrawListRenderer>();
+            }
+
+            Renderer->Render(*Context->GetRenderBuffer(), Context->GetAGGPixFmt(), DrawList, bSortByState);
+        }
+    }
+
+    // Redraws the region only, commands outside it are culled through the
+    // draw list grid. Max is exclusive.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void ReplayRegion(UAGGContext* Context, FIntPoint RegionMin, FIntPoint RegionMax)
+    {
+        if (IsValid(Context) && Context->HasValidRenderBuffer())
+        {
+            Context->WaitAllRenderJobs();
+
+            if (! Renderer.IsValid())
+            {
+                Renderer = MakeUnique<FAGGDrawListRenderer>();
+            }
+
+            Renderer->Render(*Context->GetRenderBuffer(), Context->GetAGGPixFmt(), DrawList, bSortByState, FIntRect(RegionMin, RegionMax));
+        }
+    }
+
+    // Rasterizes a snapshot of the recorded commands on a worker thread.
+    // The draw list may be modified or reset right after this call.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    FAGGRenderJobHandle ReplayAsync(UAGGContext* Context, FAGGRenderJobDelegate OnComplete)
+    {
+        if (IsValid(Context) && DrawList.Num() > 0)
+        {
+            return Context->LaunchRenderJob(DrawList, bSortByState, OnComplete);
+        }
+        return FAGGRenderJobHandle();
+    }
+};
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_path_storage.h"
+#include "agg_curves.h"
+
+#include "CoreMinimal.h"
+#include "UniquePtr.h"
+
+// Frame scoped pools for temporary geometry, reclaimed in one shot at the
+// end of the frame. Scratch paths and curves keep their vertex blocks when
+// returned, so temporaries stop reaching the global allocator once the pools
+// are warm. Pools shrink back to the recent peak usage after MaxIdleFrames
+// and paths drop their blocks past MaxRetainedVertices.
+//
+// Game thread only, scratch handles created on other threads own their
+// object instead.
+
+class AGGPLUGIN_API FAGGFrameArena
+{
+public:
+
+    enum { MaxIdleFrames = 120 };
+    enum { MaxRetainedVertices = 16*1024 };
+
+    static FAGGFrameArena& Get();
+
+    FORCEINLINE static bool IsAvailable()
+    {
+        return IsInGameThread();
+    }
+
+    // Frame end callback, rewinds the arena
+    static void OnEndFrame();
+
+    ~FAGGFrameArena();
+
+    template<class T>
+    T* Acquire()
+    {
+        T* Object = GetPool(static_cast<T*>(nullptr)).Acquire();
+        ClearScratch(*Object);
+        return Object;
+    }
+
+    // Returns a scratch object, objects acquired in an earlier frame were
+    // already reclaimed by the frame reset
+    template<class T>
+    void Release(T* Object, uint32 AcquireFrame)
+    {
+        if (AcquireFrame == Frame)
+        {
+            GetPool(static_cast<T*>(nullptr)).Release(Object);
+        }
+    }
+
+    FORCEINLINE uint32 GetFrame() const
+    {
+        return Frame;
+    }
+
+    // Reclaims all scratch objects and trims idle pool capacity
+    void Reset();
+
+    // Frees all scratch objects
+    void Trim();
+
+private:
+
+    template<class T>
+    struct TScratchPool
+    {
+        TArray<TUniquePtr<T>> Objects;
+        TArray<T*> Free;
+
+        // Objects in use and the peak of the current frame
+        int32 InUse = 0;
+        int32 FramePeak = 0;
+
+        // Objects kept across frames, lowered to the frame peak once no frame
+        // needed them for MaxIdleFrames
+        int32 RetainCount = 0;
+        int32 IdleFrames = 0;
+
+        T* Acquire()
+        {
+            FramePeak = FMath::Max(FramePeak, ++InUse);
+
+            if (Free.Num() > 0)
+            {
+                return Free.Pop(false);
+            }
+
+            Objects.Emplace(new T);
+            return Objects.Last().Get();
+        }
+
+        FORCEINLINE void Release(T* Object)
+        {
+            --InUse;
+            TrimScratch(*Object);
+            Free.Emplace(Object);
+        }
+
+        void Reset()
+        {
+            // Objects still held by a live handle must not be freed
+
+            if (InUse == 0)
+            {
+                if (FramePeak >= RetainCount)
+                {
+                    RetainCount = FramePeak;
+                    IdleFrames = 0;
+                }
+                else
+                if (++IdleFrames > MaxIdleFrames)
+                {
+                    RetainCount = FramePeak;
+                    IdleFrames = 0;
+                }
+
+                if (Objects.Num() > RetainCount)
+                {
+                    Objects.SetNum(RetainCount);
+                }
+
+                for (TUniquePtr<T>& Object : Objects)
+                {
+                    TrimScratch(*Object);
+                }
+            }
+
+            InUse = 0;
+            FramePeak = 0;
+            Free.Reset();
+
+            for (TUniquePtr<T>& Object : Objects)
+            {
+                Free.Emplace(Object.Get());
+            }
+        }
+
+        void Empty()
+        {
+            Free.Empty();
+            Objects.Empty();
+            InUse = 0;
+            FramePeak = 0;
+            RetainCount = 0;
+            IdleFrames = 0;
+        }
+    };
+
+    FORCEINLINE TScratchPool<agg::path_storage>& GetPool(agg::path_storage*)
+    {
+        return PathPool;
+    }
+
+    FORCEINLINE TScratchPool<agg::curve3>& GetPool(agg::curve3*)
+    {
+        return Curve3Pool;
+    }
+
+    FORCEINLINE static void ClearScratch(agg::path_storage& Path)
+    {
+        Path.remove_all();
+    }
+
+    FORCEINLINE static void ClearScratch(agg::curve3& Curve)
+    {
+        Curve.reset();
+        Curve.approximation_method(agg::curve_div);
+        Curve.approximation_scale(1.0);
+        Curve.angle_tolerance(0.0);
+    }
+
+    // Drops vertex blocks of oversized paths, curve point storage is bounded
+    // by the subdivision recursion limit
+
+    FORCEINLINE static void TrimScratch(agg::path_storage& Path)
+    {
+        if (Path.total_vertices() > MaxRetainedVertices)
+        {
+            Path.free_all();
+        }
+    }
+
+    FORCEINLINE static void TrimScratch(agg::curve3& Curve)
+    {
+    }
+
+    uint32 Frame = 0;
+
+    TScratchPool<agg::path_storage> PathPool;
+    TScratchPool<agg::curve3> Curve3Pool;
+};
+
+// Scratch object handle, returns the object to the frame arena on scope exit
+
+template<class T>
+class TAGGScratch
+{
+    T* Object = nullptr;
+    TUniquePtr<T> Owned;
+    uint32 Frame = 0;
+
+public:
+
+    TAGGScratch()
+    {
+        if (FAGGFrameArena::IsAvailable())
+        {
+            FAGGFrameArena& Arena( FAGGFrameArena::Get() );
+            Object = Arena.Acquire<T>();
+            Frame = Arena.GetFrame();
+        }
+        else
+        {
+            Owned = MakeUnique<T>();
+            Object = Owned.Get();
+        }
+    }
+
+    ~TAGGScratch()
+    {
+        if (! Owned.IsValid())
+        {
+            FAGGFrameArena::Get().Release(Object, Frame);
+        }
+    }
+
+    FORCEINLINE T& operator*()
+    {
+        return *Object;
+    }
+
+    FORCEINLINE T* operator->()
+    {
+        return Object;
+    }
+
+private:
+
+    // Non-Copyable
+    TAGGScratch(const TAGGScratch&) = delete;
+    const TAGGScratch& operator=(const TAGGScratch&) = delete;
+};
+
+typedef TAGGScratch<agg::path_storage> FAGGScratchPath;
+typedef TAGGScratch<agg::curve3> FAGGScratchCurve3;
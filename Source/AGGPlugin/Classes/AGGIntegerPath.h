@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_basics.h"
+#include "agg_path_storage.h"
+#include "agg_path_storage_integer.h"
+#include "agg_trans_affine.h"
+#include "agg_conv_curve.h"
+#include "agg_conv_transform.h"
+
+#include "CoreMinimal.h"
+
+// Polygon path with vertices packed into integer coordinate pairs. Vertices
+// are quantized to 1/(1<<CoordShift) pixels on insertion, the path command
+// is stored in the low bit of each coordinate. Subpaths are closed
+// implicitly when filled, FPolylineSource reads them as open polylines for
+// outline and stroke rendering. Curves are flattened before insertion.
+
+template<class T, unsigned CoordShift>
+class TAGGIntegerPath
+{
+public:
+
+    static_assert(CoordShift <= agg::poly_subpixel_shift, "Integer path precision exceeds rasterizer subpixel precision");
+
+    typedef agg::path_storage_integer<T, CoordShift> FStorage;
+    typedef typename FStorage::vertex_integer_type FVertex;
+
+    // Vertex source without the implicit close commands of the storage
+    class FPolylineSource
+    {
+    public:
+
+        FPolylineSource(TAGGIntegerPath& InPath)
+            : Path(InPath)
+        {
+        }
+
+        FORCEINLINE void rewind(unsigned PathId)
+        {
+            Path.rewind(PathId);
+        }
+
+        FORCEINLINE unsigned vertex(double* X, double* Y)
+        {
+            unsigned Cmd;
+            while (agg::is_end_poly(Cmd = Path.vertex(X, Y)));
+            return Cmd;
+        }
+
+    private:
+
+        TAGGIntegerPath& Path;
+    };
+
+    enum
+    {
+        CoordScale = 1 << CoordShift,
+        CoordMax = (1 << (sizeof(T)*8 - 2)) - 1,
+        SubpixelScale = 1 << (agg::poly_subpixel_shift - CoordShift)
+    };
+
+    // Largest representable absolute coordinate in pixels
+    FORCEINLINE static double GetCoordLimit()
+    {
+        return double(CoordMax) / CoordScale;
+    }
+
+    FORCEINLINE static T Quantize(double V)
+    {
+        return T(FMath::Clamp(agg::iround(V * CoordScale), -int32(CoordMax), int32(CoordMax)));
+    }
+
+    FORCEINLINE static int32 ToSubpixel(T V)
+    {
+        return int32(V >> 1) * SubpixelScale;
+    }
+
+    FORCEINLINE void MoveTo(double X, double Y)
+    {
+        Storage.move_to(Quantize(X), Quantize(Y));
+    }
+
+    FORCEINLINE void LineTo(double X, double Y)
+    {
+        Storage.line_to(Quantize(X), Quantize(Y));
+    }
+
+    void AddPolygon(const TArray<FVector2D>& Points)
+    {
+        if (Points.Num() < 3)
+        {
+            return;
+        }
+
+        MoveTo(Points[0].X, Points[0].Y);
+
+        for (int32 i=1; i<Points.Num(); ++i)
+        {
+            LineTo(Points[i].X, Points[i].Y);
+        }
+    }
+
+    void AddPolyline(const TArray<FVector2D>& Points)
+    {
+        if (Points.Num() < 2)
+        {
+            return;
+        }
+
+        MoveTo(Points[0].X, Points[0].Y);
+
+        for (int32 i=1; i<Points.Num(); ++i)
+        {
+            LineTo(Points[i].X, Points[i].Y);
+        }
+    }
+
+    // Appends the transformed path, curves are flattened with the default
+    // approximation scale
+    void AddPath(agg::path_storage& Path, const agg::trans_affine& Transform)
+    {
+        typedef agg::conv_transform<agg::path_storage> FTransformed;
+        typedef agg::conv_curve<FTransformed> FCurved;
+
+        FTransformed Transformed(Path, Transform);
+        FCurved Curved(Transformed);
+
+        double X;
+        double Y;
+        unsigned Cmd;
+
+        Curved.rewind(0);
+
+        while (! agg::is_stop(Cmd = Curved.vertex(&X, &Y)))
+        {
+            if (agg::is_move_to(Cmd))
+            {
+                MoveTo(X, Y);
+            }
+            else
+            if (agg::is_vertex(Cmd))
+            {
+                LineTo(X, Y);
+            }
+        }
+    }
+
+    // Feeds vertices to the rasterizer in subpixel units, skipping the
+    // conversion to double coordinates. Requires an integer clipper.
+    template<class FRasterizer>
+    void AddTo(FRasterizer& Rasterizer) const
+    {
+        const unsigned Count = Storage.size();
+
+        for (unsigned i=0; i<Count; ++i)
+        {
+            const FVertex& Vertex( Storage.raw_vertex(i) );
+            const int32 X = ToSubpixel(Vertex.x);
+            const int32 Y = ToSubpixel(Vertex.y);
+
+            if ((Vertex.x & 1) == FVertex::cmd_move_to)
+            {
+                Rasterizer.move_to(X, Y);
+            }
+            else
+            {
+                Rasterizer.line_to(X, Y);
+            }
+        }
+    }
+
+    FORCEINLINE FPolylineSource GetPolylineSource()
+    {
+        return FPolylineSource(*this);
+    }
+
+    // Vertex source interface
+
+    FORCEINLINE void rewind(unsigned PathId)
+    {
+        Storage.rewind(PathId);
+    }
+
+    FORCEINLINE unsigned vertex(double* X, double* Y)
+    {
+        return Storage.vertex(X, Y);
+    }
+
+    FORCEINLINE void Reset()
+    {
+        Storage.remove_all();
+    }
+
+    FORCEINLINE int32 Num() const
+    {
+        return Storage.size();
+    }
+
+    FORCEINLINE bool IsEmpty() const
+    {
+        return Storage.size() == 0;
+    }
+
+    FORCEINLINE int32 GetAllocatedSize() const
+    {
+        return Storage.byte_size();
+    }
+
+    FORCEINLINE FStorage& GetStorage()
+    {
+        return Storage;
+    }
+
+    FORCEINLINE const FStorage& GetStorage() const
+    {
+        return Storage;
+    }
+
+private:
+
+    FStorage Storage;
+};
+
+// 4 bytes per vertex, pixel snapped
+typedef TAGGIntegerPath<int16, 0> FAGGIntegerPath16;
+
+// 8 bytes per vertex, full rasterizer subpixel precision
+typedef TAGGIntegerPath<int32, agg::poly_subpixel_shift> FAGGIntegerPath32;
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreUObject.h"
+
+#include "AGGTypes.h"
+#include "AGGIntegerPath.h"
+#include "AGGPathController.h"
+#include "AGGIntegerPathObject.generated.h"
+
+// Compact path for large static geometry such as map layers. Filled as
+// polygons by the scanline renderer, outlined or stroked as open polylines.
+
+UCLASS(BlueprintType)
+class AGGPLUGIN_API UAGGIntegerPath : public UObject
+{
+	GENERATED_BODY()
+
+    FAGGIntegerPath16 Path16;
+    FAGGIntegerPath32 Path32;
+
+public:
+
+    UPROPERTY(BlueprintReadOnly)
+    EAGGIntegerPathFormat Format = EAGGIntegerPathFormat::IPF_Int32;
+
+    FORCEINLINE FAGGIntegerPath16& GetPath16()
+    {
+        return Path16;
+    }
+
+    FORCEINLINE FAGGIntegerPath32& GetPath32()
+    {
+        return Path32;
+    }
+
+    // Changes the coordinate format, clears the path
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void SetFormat(EAGGIntegerPathFormat InFormat)
+    {
+        Clear();
+        Format = InFormat;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void MoveTo(FVector2D Point)
+    {
+        if (Format == EAGGIntegerPathFormat::IPF_Int16)
+        {
+            Path16.MoveTo(Point.X, Point.Y);
+        }
+        else
+        {
+            Path32.MoveTo(Point.X, Point.Y);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void LineTo(FVector2D Point)
+    {
+        if (Format == EAGGIntegerPathFormat::IPF_Int16)
+        {
+            Path16.LineTo(Point.X, Point.Y);
+        }
+        else
+        {
+            Path32.LineTo(Point.X, Point.Y);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void AddPolygon(const TArray<FVector2D>& Points)
+    {
+        if (Format == EAGGIntegerPathFormat::IPF_Int16)
+        {
+            Path16.AddPolygon(Points);
+        }
+        else
+        {
+            Path32.AddPolygon(Points);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void AddPolyline(const TArray<FVector2D>& Points)
+    {
+        if (Format == EAGGIntegerPathFormat::IPF_Int16)
+        {
+            Path16.AddPolyline(Points);
+        }
+        else
+        {
+            Path32.AddPolyline(Points);
+        }
+    }
+
+    // Appends the render path of the source with its transform applied
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void AddPath(UAGGPathController* Path)
+    {
+        if (! IsValid(Path))
+        {
+            return;
+        }
+
+        agg::trans_affine Transform;
+        agg::path_storage& RenderPath( Path->GetRenderPath(Transform) );
+
+        if (Format == EAGGIntegerPathFormat::IPF_Int16)
+        {
+            Path16.AddPath(RenderPath, Transform);
+        }
+        else
+        {
+            Path32.AddPath(RenderPath, Transform);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Clear()
+    {
+        Path16.Reset();
+        Path32.Reset();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 Num() const
+    {
+        return Format == EAGGIntegerPathFormat::IPF_Int16
+            ? Path16.Num()
+            : Path32.Num();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 GetAllocatedSize() const
+    {
+        return Format == EAGGIntegerPathFormat::IPF_Int16
+            ? Path16.GetAllocatedSize()
+            : Path32.GetAllocatedSize();
+    }
+
+    // Largest representable absolute coordinate in pixels
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    float GetCoordLimit() const
+    {
+        return Format == EAGGIntegerPathFormat::IPF_Int16
+            ? FAGGIntegerPath16::GetCoordLimit()
+            : FAGGIntegerPath32::GetCoordLimit();
+    }
+};
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_basics.h"
+#include "agg_path_storage.h"
+
+#include "CoreMinimal.h"
+
+// Polylines with per-line width and color rendered by the outline renderer
+// in one batch. Vertices share a single path storage, each line references
+// its vertices by path id.
+
+class AGGPLUGIN_API FAGGOutlineBatch
+{
+public:
+
+    struct FLine
+    {
+        uint32 PathId;
+        float Width;
+        FColor Color;
+
+        FLine() = default;
+
+        FLine(uint32 InPathId, float InWidth, FColor InColor)
+            : PathId(InPathId)
+            , Width(InWidth)
+            , Color(InColor)
+        {
+        }
+    };
+
+private:
+
+    agg::path_storage Paths;
+    TArray<FLine> Lines;
+
+public:
+
+    FORCEINLINE int32 Num() const
+    {
+        return Lines.Num();
+    }
+
+    FORCEINLINE agg::path_storage& GetPaths()
+    {
+        return Paths;
+    }
+
+    FORCEINLINE const TArray<FLine>& GetLines() const
+    {
+        return Lines;
+    }
+
+    // Clears recorded lines while keeping allocated storage
+
+    void Reset()
+    {
+        Paths.remove_all();
+        Lines.Reset();
+    }
+
+    void AddPath(agg::path_storage& Path, float Width, FColor Color)
+    {
+        const uint32 PathId = Paths.start_new_path();
+        Paths.concat_path(Path);
+        Lines.Emplace(PathId, Width, Color);
+    }
+
+    void AddPolyline(const TArray<FVector2D>& Points, float Width, FColor Color, bool bClosePolygon)
+    {
+        if (Points.Num() < 2)
+        {
+            return;
+        }
+
+        const uint32 PathId = Paths.start_new_path();
+
+        Paths.move_to(Points[0].X, Points[0].Y);
+
+        for (int32 i=1; i<Points.Num(); ++i)
+        {
+            Paths.line_to(Points[i].X, Points[i].Y);
+        }
+
+        if (bClosePolygon)
+        {
+            Paths.close_polygon();
+        }
+
+        Lines.Emplace(PathId, Width, Color);
+    }
+};
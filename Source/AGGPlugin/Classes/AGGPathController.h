@@ -35,10 +35,17 @@
 #include "agg_conv_curve.h"
 #include "agg_conv_dash.h"
 #include "agg_conv_stroke.h"
+#include "agg_conv_contour.h"
 #include "agg_conv_transform.h"
 
 #include "CoreUObject.h"
 #include "Queue.h"
+#include "UniquePtr.h"
+
+#include "AGGCurveCache.h"
+#include "AGGFrameArena.h"
+#include "AGGPathTransform.h"
+#include "AGGPathSimplify.h"
 #include "AGGPathController.generated.h"
 
 // ---------------------------- Path Conversion Types
@@ -49,7 +56,8 @@ enum class EAGGPathConv : uint8
 	STROKE,
 	DASH,
 	CURVE,
-	CONTOUR
+	CONTOUR,
+	SIMPLIFY
 };
 
 // ---------------------------- Stroke Settings
@@ -124,38 +132,975 @@ struct AGGPLUGIN_API FAGGDashSettings
 {
 	GENERATED_BODY()
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    FAGGStrokeSettings StrokeSettings;
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    FAGGStrokeSettings StrokeSettings;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    TArray<FAGGDashComp> DashCompositions;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float DashStart = 0.f;
+};
+
+// ---------------------------- Curve Settings
+
+UENUM(BlueprintType)
+enum class EAGGCurveApproxMethod : uint8
+{
+    CURVE_INC,
+    CURVE_DIV
+};
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGCurveSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    EAGGCurveApproxMethod ApproximationMethod = EAGGCurveApproxMethod::CURVE_DIV;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float ApproximationScale = 1.f;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float AngleTolerance = 0.f;
+
+    // Derives the approximation scale from the path transform scale and
+    // ResolutionScale, ApproximationScale becomes a quality multiplier. Only
+    // used by curve conversions queued on a path, the transform scale only
+    // if the transform is applied when rendering.
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    bool bAutoScale = false;
+
+    // Target buffer pixels per rendered pixel, used by automatic scale
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float ResolutionScale = 1.f;
+
+    // Shares flattened curve segments through the curve cache. The scale is
+    // rounded up to the next cached scale step.
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    bool bCacheSegments = false;
+};
+
+// ---------------------------- Contour Settings
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGContourSettings
+{
+	GENERATED_BODY()
+
+    // Offset distance, positive inflates and negative deflates the polygon
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float Width = 1.f;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float MiterLimit = 4.f;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float InnerMiterLimit = 1.01f;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    EAGGLineJoin LineJoin = EAGGLineJoin::MITER_JOIN;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    EAGGInnerJoin InnerJoin = EAGGInnerJoin::INNER_MITER;
+
+    // Offsets outward regardless of polygon winding
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    bool bAutoDetectOrientation = true;
+};
+
+// ---------------------------- Simplify Settings
+
+UENUM(BlueprintType)
+enum class EAGGSimplifyMethod : uint8
+{
+    DOUGLAS_PEUCKER,
+    VISVALINGAM_WHYATT
+};
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGSimplifySettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    EAGGSimplifyMethod Method = EAGGSimplifyMethod::DOUGLAS_PEUCKER;
+
+    // Maximum deviation in output pixels, divided by the transform scale
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+    float Tolerance = .5f;
+};
+
+// ---------------------------- Path Conversion
+
+// Queued path conversions compiled into a chain of AGG converters. The chain
+// streams vertices from the source path, intermediate paths are never
+// stored. The compiled chain is kept until the queue or source changes.
+
+class AGGPLUGIN_API FAGGPathConversion
+{
+public:
+
+    struct IVertexSource
+    {
+        virtual ~IVertexSource() = default;
+        virtual void rewind(unsigned PathId) = 0;
+        virtual unsigned vertex(double* x, double* y) = 0;
+    };
+
+private:
+
+    struct FEntry
+    {
+        EAGGPathConv ConversionType;
+        int32 SettingIndex;
+
+        FEntry() = default;
+
+        FEntry(EAGGPathConv t, int32 i)
+            : ConversionType(t)
+            , SettingIndex(i)
+        {
+        }
+    };
+
+    // Non-virtual vertex source handed to AGG converters
+    class FSourceRef
+    {
+        IVertexSource* Source;
+
+    public:
+
+        FSourceRef(IVertexSource& InSource) : Source(&InSource)
+        {
+        }
+
+        FORCEINLINE void rewind(unsigned PathId)
+        {
+            Source->rewind(PathId);
+        }
+
+        FORCEINLINE unsigned vertex(double* x, double* y)
+        {
+            return Source->vertex(x, y);
+        }
+    };
+
+    template<class FConv>
+    struct TStage : public IVertexSource
+    {
+        FSourceRef Input;
+        FConv Conv;
+
+        TStage(IVertexSource& InSource) : Input(InSource), Conv(Input)
+        {
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Conv.rewind(PathId);
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            return Conv.vertex(x, y);
+        }
+    };
+
+    struct FPathStage : public IVertexSource
+    {
+        agg::path_storage& Path;
+
+        FPathStage(agg::path_storage& InPath) : Path(InPath)
+        {
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Path.rewind(PathId);
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            return Path.vertex(x, y);
+        }
+    };
+
+    struct FDashStage : public IVertexSource
+    {
+        FSourceRef Input;
+        agg::conv_dash<FSourceRef> Dash;
+        agg::conv_stroke< agg::conv_dash<FSourceRef> > Stroke;
+
+        FDashStage(IVertexSource& InSource) : Input(InSource), Dash(Input), Stroke(Dash)
+        {
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Stroke.rewind(PathId);
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            return Stroke.vertex(x, y);
+        }
+    };
+
+    struct FTransformStage : public IVertexSource
+    {
+        FSourceRef Input;
+        agg::conv_transform<FSourceRef> Transform;
+
+        FTransformStage(IVertexSource& InSource, const agg::trans_affine& InTransform)
+            : Input(InSource)
+            , Transform(Input, InTransform)
+        {
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Transform.rewind(PathId);
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            return Transform.vertex(x, y);
+        }
+    };
+
+    // Buffers one subpath at a time and emits it simplified. Subpaths with
+    // curve commands are passed through unchanged. The pixel tolerance is
+    // mapped to path units only if the transform is applied downstream.
+    struct FSimplifyStage : public IVertexSource
+    {
+        typedef FAGGPathSimplifier::FVertex FVertex;
+
+        FSourceRef Input;
+        FAGGSimplifySettings Settings;
+        const agg::trans_affine* Transform;
+
+        FAGGPathSimplifier Simplifier;
+        TArray<FVertex> Vertices;
+        FVertex Lookahead;
+        double Tolerance = 0.0;
+        int32 OutIndex = 0;
+        unsigned PendingEnd = agg::path_cmd_stop;
+        bool bHasLookahead = false;
+        bool bDone = false;
+
+        FSimplifyStage(IVertexSource& InSource, const FAGGSimplifySettings& InSettings, const agg::trans_affine* InTransform)
+            : Input(InSource)
+            , Settings(InSettings)
+            , Transform(InTransform)
+        {
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Input.rewind(PathId);
+            Vertices.Reset();
+            Tolerance = Transform
+                ? Settings.Tolerance / FMath::Max(Transform->scale(), 1e-6)
+                : Settings.Tolerance;
+            OutIndex = 0;
+            PendingEnd = agg::path_cmd_stop;
+            bHasLookahead = false;
+            bDone = false;
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            while (true)
+            {
+                if (OutIndex < Vertices.Num())
+                {
+                    const FVertex& Vertex( Vertices[OutIndex++] );
+                    *x = Vertex.X;
+                    *y = Vertex.Y;
+                    return Vertex.Cmd;
+                }
+
+                if (PendingEnd != agg::path_cmd_stop)
+                {
+                    const unsigned Cmd = PendingEnd;
+                    PendingEnd = agg::path_cmd_stop;
+                    *x = 0.0;
+                    *y = 0.0;
+                    return Cmd;
+                }
+
+                if (bDone && ! bHasLookahead)
+                {
+                    return agg::path_cmd_stop;
+                }
+
+                ReadSubpath();
+            }
+        }
+
+        void ReadSubpath()
+        {
+            Vertices.Reset();
+            OutIndex = 0;
+
+            if (bHasLookahead)
+            {
+                Vertices.Emplace(Lookahead);
+                bHasLookahead = false;
+            }
+
+            bool bHasCurves = false;
+            double vx, vy;
+            unsigned Cmd;
+
+            while (! bDone)
+            {
+                Cmd = Input.vertex(&vx, &vy);
+
+                if (agg::is_stop(Cmd))
+                {
+                    bDone = true;
+                }
+                else
+                if (agg::is_end_poly(Cmd))
+                {
+                    PendingEnd = Cmd;
+                    break;
+                }
+                else
+                if (agg::is_move_to(Cmd) && Vertices.Num() > 0)
+                {
+                    Lookahead = { vx, vy, Cmd };
+                    bHasLookahead = true;
+                    break;
+                }
+                else
+                if (agg::is_vertex(Cmd))
+                {
+                    bHasCurves |= agg::is_curve(Cmd);
+                    Vertices.Add({ vx, vy, Cmd });
+                }
+            }
+
+            if (bHasCurves || Vertices.Num() < 3)
+            {
+                return;
+            }
+
+            if (Settings.Method == EAGGSimplifyMethod::VISVALINGAM_WHYATT)
+            {
+                Simplifier.VisvalingamWhyatt(Vertices, Tolerance);
+            }
+            else
+            {
+                Simplifier.DouglasPeucker(Vertices, Tolerance);
+            }
+        }
+    };
+
+    // Curve conversion with the approximation scale resolved at rewind from
+    // the path transform, if it is applied downstream. Curve commands are
+    // flattened into segments that are optionally shared through the curve
+    // cache.
+    struct FAdaptiveCurveStage : public IVertexSource
+    {
+        typedef FAGGCurveCache::FSegment FSegment;
+
+        FSourceRef Input;
+        FAGGCurveSettings Settings;
+        const agg::trans_affine* Transform;
+
+        agg::curve3 Curve3;
+        agg::curve4 Curve4;
+        FAGGCurveCache::FSegmentRef CachedSegment;
+        FSegment LocalSegment;
+        const FSegment* Segment = nullptr;
+        int32 SegmentIndex = 0;
+        int32 ScaleStep = 0;
+        double LastX = 0.0;
+        double LastY = 0.0;
+
+        FAdaptiveCurveStage(IVertexSource& InSource, const FAGGCurveSettings& InSettings, const agg::trans_affine* InTransform)
+            : Input(InSource)
+            , Settings(InSettings)
+            , Transform(InTransform)
+        {
+            ApplyCurveSettings(Curve3, Settings);
+            ApplyCurveSettings(Curve4, Settings);
+        }
+
+        virtual void rewind(unsigned PathId) override
+        {
+            Input.rewind(PathId);
+
+            double Scale = Settings.ApproximationScale;
+
+            if (Settings.bAutoScale)
+            {
+                Scale *= Settings.ResolutionScale;
+
+                if (Transform)
+                {
+                    Scale *= Transform->scale();
+                }
+            }
+
+            if (Settings.bCacheSegments)
+            {
+                ScaleStep = FAGGCurveCache::GetScaleStep(Scale);
+                Scale = FAGGCurveCache::GetStepScale(ScaleStep);
+            }
+
+            Curve3.approximation_scale(Scale);
+            Curve4.approximation_scale(Scale);
+
+            CachedSegment.Reset();
+            Segment = nullptr;
+            SegmentIndex = 0;
+            LastX = 0.0;
+            LastY = 0.0;
+        }
+
+        virtual unsigned vertex(double* x, double* y) override
+        {
+            if (Segment)
+            {
+                if (SegmentIndex < Segment->Num())
+                {
+                    *x = LastX = (*Segment)[SegmentIndex];
+                    *y = LastY = (*Segment)[SegmentIndex+1];
+                    SegmentIndex += 2;
+                    return agg::path_cmd_line_to;
+                }
+
+                Segment = nullptr;
+            }
+
+            double Coords[8] = { LastX, LastY };
+            const unsigned Cmd = Input.vertex(x, y);
+
+            switch (Cmd)
+            {
+                case agg::path_cmd_curve3:
+                    Coords[2] = *x;
+                    Coords[3] = *y;
+                    Input.vertex(&Coords[4], &Coords[5]);
+                    SetSegment(Coords, 6);
+                    return vertex(x, y);
+
+                case agg::path_cmd_curve4:
+                    Coords[2] = *x;
+                    Coords[3] = *y;
+                    Input.vertex(&Coords[4], &Coords[5]);
+                    Input.vertex(&Coords[6], &Coords[7]);
+                    SetSegment(Coords, 8);
+                    return vertex(x, y);
+            }
+
+            if (agg::is_vertex(Cmd))
+            {
+                LastX = *x;
+                LastY = *y;
+            }
+
+            return Cmd;
+        }
+
+        void SetSegment(const double* Coords, int32 NumCoords)
+        {
+            SegmentIndex = 0;
+
+            if (! Settings.bCacheSegments)
+            {
+                Flatten(LocalSegment, Coords, NumCoords);
+                Segment = &LocalSegment;
+                return;
+            }
+
+            FAGGCurveCache& Cache( FAGGCurveCache::Get() );
+            FAGGCurveCache::FKey Key;
+            FMemory::Memcpy(Key.Coords, Coords, NumCoords * sizeof(double));
+            Key.ScaleStep = ScaleStep;
+            Key.AngleTolerance = Settings.AngleTolerance;
+            Key.Method = uint8(Settings.ApproximationMethod);
+            Key.NumCoords = NumCoords;
+
+            CachedSegment = Cache.Find(Key);
+
+            if (! CachedSegment.IsValid())
+            {
+                TSharedPtr<FSegment, ESPMode::ThreadSafe> NewSegment(new FSegment);
+                Flatten(*NewSegment, Coords, NumCoords);
+                CachedSegment = NewSegment;
+                Cache.Add(Key, CachedSegment);
+            }
+
+            Segment = CachedSegment.Get();
+        }
+
+        void Flatten(FSegment& OutSegment, const double* Coords, int32 NumCoords)
+        {
+            OutSegment.Reset();
+
+            if (NumCoords == 6)
+            {
+                Curve3.init(Coords[0], Coords[1], Coords[2], Coords[3], Coords[4], Coords[5]);
+                ReadCurve(Curve3, OutSegment);
+            }
+            else
+            {
+                Curve4.init(Coords[0], Coords[1], Coords[2], Coords[3], Coords[4], Coords[5], Coords[6], Coords[7]);
+                ReadCurve(Curve4, OutSegment);
+            }
+        }
+
+        // Reads curve points after the curve start
+        template<class FCurve>
+        static void ReadCurve(FCurve& Curve, FSegment& OutSegment)
+        {
+            double x, y;
+
+            Curve.rewind(0);
+            Curve.vertex(&x, &y);
+
+            while (! agg::is_stop(Curve.vertex(&x, &y)))
+            {
+                OutSegment.Add(x);
+                OutSegment.Add(y);
+            }
+        }
+    };
+
+    typedef TStage< agg::conv_stroke<FSourceRef> > FStrokeStage;
+    typedef TStage< agg::conv_curve<FSourceRef> >  FCurveStage;
+    typedef TStage< agg::conv_contour<FSourceRef> > FContourStage;
+
+    TArray<FEntry> Entries;
+    TArray<FAGGStrokeSettings> StrokeSettings;
+    TArray<FAGGDashSettings> DashSettings;
+    TArray<FAGGCurveSettings> CurveSettings;
+    TArray<FAGGContourSettings> ContourSettings;
+    TArray<FAGGSimplifySettings> SimplifySettings;
+
+    TArray<TUniquePtr<IVertexSource>> Stages;
+    const agg::path_storage* CompiledPath = nullptr;
+    const agg::trans_affine* CompiledTransform = nullptr;
+    bool bCompiledApplyTransform = false;
+    bool bCompiledTransformDownstream = false;
+
+public:
+
+    FAGGPathConversion() = default;
+
+    // Compiled stages reference the owner path, copies only take the queue
+    FAGGPathConversion(const FAGGPathConversion& Other)
+        : Entries(Other.Entries)
+        , StrokeSettings(Other.StrokeSettings)
+        , DashSettings(Other.DashSettings)
+        , CurveSettings(Other.CurveSettings)
+        , ContourSettings(Other.ContourSettings)
+        , SimplifySettings(Other.SimplifySettings)
+    {
+    }
+
+    FAGGPathConversion& operator=(const FAGGPathConversion& Other)
+    {
+        if (this != &Other)
+        {
+            Entries = Other.Entries;
+            StrokeSettings = Other.StrokeSettings;
+            DashSettings = Other.DashSettings;
+            CurveSettings = Other.CurveSettings;
+            ContourSettings = Other.ContourSettings;
+            SimplifySettings = Other.SimplifySettings;
+            Invalidate();
+        }
+        return *this;
+    }
+
+    FORCEINLINE bool IsEmpty() const
+    {
+        return Entries.Num() == 0;
+    }
+
+    void AddStroke(const FAGGStrokeSettings& Settings)
+    {
+        Entries.Emplace(EAGGPathConv::STROKE, StrokeSettings.Add(Settings));
+        Invalidate();
+    }
+
+    void AddDash(const FAGGDashSettings& Settings)
+    {
+        if (Settings.DashCompositions.Num() > 0)
+        {
+            Entries.Emplace(EAGGPathConv::DASH, DashSettings.Add(Settings));
+            Invalidate();
+        }
+    }
+
+    void AddCurve(const FAGGCurveSettings& Settings)
+    {
+        Entries.Emplace(EAGGPathConv::CURVE, CurveSettings.Add(Settings));
+        Invalidate();
+    }
+
+    void AddContour(const FAGGContourSettings& Settings)
+    {
+        Entries.Emplace(EAGGPathConv::CONTOUR, ContourSettings.Add(Settings));
+        Invalidate();
+    }
+
+    void AddSimplify(const FAGGSimplifySettings& Settings)
+    {
+        Entries.Emplace(EAGGPathConv::SIMPLIFY, SimplifySettings.Add(Settings));
+        Invalidate();
+    }
+
+    void Empty()
+    {
+        Entries.Reset();
+        StrokeSettings.Reset();
+        DashSettings.Reset();
+        CurveSettings.Reset();
+        ContourSettings.Reset();
+        SimplifySettings.Reset();
+        Invalidate();
+    }
+
+    FORCEINLINE void Invalidate()
+    {
+        Stages.Reset();
+        CompiledPath = nullptr;
+        CompiledTransform = nullptr;
+        bCompiledApplyTransform = false;
+        bCompiledTransformDownstream = false;
+    }
+
+    // Returns the converted vertex source of the path, optionally transformed
+    // last. If the transform is applied, here or later by the caller, its
+    // scale maps pixel tolerances to path units. Otherwise the path is
+    // assumed to be in pixels already, e.g. with the transform baked in.
+    // The source stays valid until the queue changes.
+    IVertexSource& Compile(agg::path_storage& Path, const agg::trans_affine& Transform, bool bApplyTransform = false, bool bTransformDownstream = false)
+    {
+        bTransformDownstream |= bApplyTransform;
+
+        if (Stages.Num() > 0 && CompiledPath == &Path && CompiledTransform == &Transform
+            && bCompiledApplyTransform == bApplyTransform && bCompiledTransformDownstream == bTransformDownstream)
+        {
+            return *Stages.Last();
+        }
+
+        Invalidate();
+        Stages.Emplace(new FPathStage(Path));
+
+        const agg::trans_affine* ScaleTransform = bTransformDownstream ? &Transform : nullptr;
+
+        for (const FEntry& Entry : Entries)
+        {
+            IVertexSource& Input( *Stages.Last() );
+            const int32 s( Entry.SettingIndex );
+
+            switch (Entry.ConversionType)
+            {
+                case EAGGPathConv::STROKE:
+                    if (StrokeSettings.IsValidIndex(s))
+                    {
+                        FStrokeStage* Stage = new FStrokeStage(Input);
+                        ApplyStrokeSettings(Stage->Conv, StrokeSettings[s]);
+                        Stages.Emplace(Stage);
+                    }
+                    break;
+
+                case EAGGPathConv::DASH:
+                    if (DashSettings.IsValidIndex(s))
+                    {
+                        const FAGGDashSettings& ds( DashSettings[s] );
+                        FDashStage* Stage = new FDashStage(Input);
+                        for (const FAGGDashComp& comp : ds.DashCompositions)
+                            Stage->Dash.add_dash(comp.DashLength, comp.GapLength);
+                        Stage->Dash.dash_start(ds.DashStart);
+                        ApplyStrokeSettings(Stage->Stroke, ds.StrokeSettings);
+                        Stages.Emplace(Stage);
+                    }
+                    break;
+
+                case EAGGPathConv::CURVE:
+                    if (CurveSettings.IsValidIndex(s))
+                    {
+                        const FAGGCurveSettings& cs( CurveSettings[s] );
+
+                        if (cs.bAutoScale || cs.bCacheSegments)
+                        {
+                            Stages.Emplace(new FAdaptiveCurveStage(Input, cs, ScaleTransform));
+                        }
+                        else
+                        {
+                            FCurveStage* Stage = new FCurveStage(Input);
+                            ApplyCurveSettings(Stage->Conv, cs);
+                            Stages.Emplace(Stage);
+                        }
+                    }
+                    break;
+
+                case EAGGPathConv::CONTOUR:
+                    if (ContourSettings.IsValidIndex(s))
+                    {
+                        FContourStage* Stage = new FContourStage(Input);
+                        ApplyContourSettings(Stage->Conv, ContourSettings[s]);
+                        Stages.Emplace(Stage);
+                    }
+                    break;
+
+                case EAGGPathConv::SIMPLIFY:
+                    if (SimplifySettings.IsValidIndex(s))
+                    {
+                        Stages.Emplace(new FSimplifyStage(Input, SimplifySettings[s], ScaleTransform));
+                    }
+                    break;
+            }
+        }
+
+        if (bApplyTransform)
+        {
+            IVertexSource& Input( *Stages.Last() );
+            Stages.Emplace(new FTransformStage(Input, Transform));
+        }
+
+        CompiledPath = &Path;
+        CompiledTransform = &Transform;
+        bCompiledApplyTransform = bApplyTransform;
+        bCompiledTransformDownstream = bTransformDownstream;
+
+        return *Stages.Last();
+    }
+
+    // Replaces the path with its converted vertices in a single pass and
+    // empties the queue. The transform is not applied, pass whether it is
+    // applied when rendering.
+    void Apply(agg::path_storage& Path, const agg::trans_affine& Transform, bool bTransformDownstream = false)
+    {
+        if (IsEmpty())
+        {
+            return;
+        }
+
+        FAGGScratchPath Converted;
+        Converted->concat_path(Compile(Path, Transform, false, bTransformDownstream));
+
+        // Swap the vertex blocks instead of copying back, the scratch path
+        // returns the old blocks to the pool
+
+        Empty();
+        Path.swap(*Converted);
+    }
+
+    template<class FStroke>
+    static void ApplyStrokeSettings(FStroke& stroke, const FAGGStrokeSettings& settings)
+    {
+        stroke.width(settings.Width);
+        stroke.line_join(agg::line_join_e(settings.LineJoin));
+        stroke.line_cap(agg::line_cap_e(settings.LineCap));
+        stroke.inner_join(agg::inner_join_e(settings.InnerJoin));
+        stroke.miter_limit(settings.MiterLimit);
+        stroke.inner_miter_limit(settings.InnerMiterLimit);
+    }
+
+    template<class FContour>
+    static void ApplyContourSettings(FContour& contour, const FAGGContourSettings& settings)
+    {
+        // vcgen_contour offsets by half the width
+        contour.width(settings.Width * 2.0);
+        contour.line_join(agg::line_join_e(settings.LineJoin));
+        contour.inner_join(agg::inner_join_e(settings.InnerJoin));
+        contour.miter_limit(settings.MiterLimit);
+        contour.inner_miter_limit(settings.InnerMiterLimit);
+        contour.auto_detect_orientation(settings.bAutoDetectOrientation);
+    }
+
+    template<class FCurve>
+    static void ApplyCurveSettings(FCurve& curve, const FAGGCurveSettings& settings)
+    {
+        curve.approximation_method(
+            agg::curve_approximation_method_e(settings.ApproximationMethod));
+        curve.approximation_scale(settings.ApproximationScale);
+        curve.angle_tolerance(agg::deg2rad(settings.AngleTolerance));
+    }
+};
+
+// ---------------------------- Bulk Geometry
+
+// Appends vertex arrays to a path storage, reserving vertex blocks once
+
+struct AGGPLUGIN_API FAGGPathBulk
+{
+    // Appends Count interleaved xy pairs as one polyline
+    template<class T>
+    static void AddVertices(agg::path_storage& Path, const T* XY, int32 Count, bool bClosePolygon)
+    {
+        if (! XY || Count < 2)
+        {
+            return;
+        }
+
+        Path.reserve(Path.total_vertices() + Count + (bClosePolygon ? 1 : 0));
+        Path.move_to(XY[0], XY[1]);
+
+        for (int32 i=1; i<Count; ++i)
+        {
+            Path.line_to(XY[i*2], XY[i*2+1]);
+        }
+
+        if (bClosePolygon)
+        {
+            Path.close_polygon();
+        }
+    }
+
+    // Appends closed rings, each ring starts at its offset and ends at the
+    // next ring offset or at the end of the vertex array
+    static void AddMultiPolygon(agg::path_storage& Path, const TArray<FVector2D>& Vertices, const TArray<int32>& RingOffsets)
+    {
+        const int32 VertexCount = Vertices.Num();
+
+        if (VertexCount < 2)
+        {
+            return;
+        }
+
+        Path.reserve(Path.total_vertices() + VertexCount + RingOffsets.Num());
+
+        for (int32 r=0; r<RingOffsets.Num(); ++r)
+        {
+            const int32 Start = FMath::Clamp(RingOffsets[r], 0, VertexCount);
+            const int32 End = RingOffsets.IsValidIndex(r+1)
+                ? FMath::Clamp(RingOffsets[r+1], Start, VertexCount)
+                : VertexCount;
+
+            if (End-Start < 2)
+            {
+                continue;
+            }
+
+            Path.move_to(Vertices[Start].X, Vertices[Start].Y);
+
+            for (int32 i=Start+1; i<End; ++i)
+            {
+                Path.line_to(Vertices[i].X, Vertices[i].Y);
+            }
+
+            Path.close_polygon();
+        }
+    }
+};
+
+// ---------------------------- Vertex Export
+
+// Read-only view over the vertex blocks of a path storage. Each block holds
+// up to BlockSize interleaved xy coordinates and their commands. The view
+// is invalidated by any path modification.
+
+class AGGPLUGIN_API FAGGPathVertexView
+{
+public:
+
+    typedef agg::path_storage::container_type FStorage;
+
+    enum { BlockShift = FStorage::block_shift, BlockSize = FStorage::block_size };
+
+private:
+
+    const FStorage& Storage;
+
+public:
+
+    FAGGPathVertexView(const agg::path_storage& Path) : Storage(Path.vertices())
+    {
+    }
+
+    FORCEINLINE int32 Num() const
+    {
+        return Storage.total_vertices();
+    }
+
+    FORCEINLINE int32 NumBlocks() const
+    {
+        return (Num() + BlockSize - 1) >> BlockShift;
+    }
+
+    FORCEINLINE int32 GetBlockNum(int32 Block) const
+    {
+        return FMath::Min(Num() - (Block << BlockShift), int32(BlockSize));
+    }
+
+    FORCEINLINE const double* GetBlockCoords(int32 Block) const
+    {
+        return Storage.block_coords(Block);
+    }
+
+    FORCEINLINE const uint8* GetBlockCommands(int32 Block) const
+    {
+        return Storage.block_commands(Block);
+    }
+
+    // Copies coordinates and commands into separate arrays, one block at a
+    // time. Output arrays keep their allocation, command output is optional.
+    template<class T>
+    void Export(TArray<T>& OutX, TArray<T>& OutY, TArray<uint8>* OutCommands = nullptr) const
+    {
+        const int32 Count = Num();
+
+        OutX.SetNumUninitialized(Count, false);
+        OutY.SetNumUninitialized(Count, false);
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    TArray<FAGGDashComp> DashCompositions;
+        if (OutCommands)
+        {
+            OutCommands->SetNumUninitialized(Count, false);
+        }
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    float DashStart = 0.f;
-};
+        for (int32 b=0; b<NumBlocks(); ++b)
+        {
+            const int32 Offset = b << BlockShift;
+            const int32 BlockNum = GetBlockNum(b);
+            const double* RESTRICT Coords = GetBlockCoords(b);
+            T* RESTRICT X = OutX.GetData() + Offset;
+            T* RESTRICT Y = OutY.GetData() + Offset;
 
-// ---------------------------- Curve Settings
+            for (int32 i=0; i<BlockNum; ++i)
+            {
+                X[i] = T(Coords[i*2]);
+                Y[i] = T(Coords[i*2+1]);
+            }
 
-UENUM(BlueprintType)
-enum class EAGGCurveApproxMethod : uint8
-{
-    CURVE_INC,
-    CURVE_DIV
-};
+            if (OutCommands)
+            {
+                FMemory::Memcpy(OutCommands->GetData() + Offset, GetBlockCommands(b), BlockNum);
+            }
+        }
+    }
 
-USTRUCT(BlueprintType)
-struct AGGPLUGIN_API FAGGCurveSettings
-{
-	GENERATED_BODY()
+    // Copies coordinates as points, output array keeps its allocation
+    void Export(TArray<FVector2D>& OutPoints) const
+    {
+        const int32 Count = Num();
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    EAGGCurveApproxMethod ApproximationMethod = EAGGCurveApproxMethod::CURVE_DIV;
+        OutPoints.SetNumUninitialized(Count, false);
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    float ApproximationScale = 1.f;
+        for (int32 b=0; b<NumBlocks(); ++b)
+        {
+            const int32 BlockNum = GetBlockNum(b);
+            const double* RESTRICT Coords = GetBlockCoords(b);
+            FVector2D* RESTRICT Points = OutPoints.GetData() + (b << BlockShift);
 
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
-    float AngleTolerance = 0.f;
+            for (int32 i=0; i<BlockNum; ++i)
+            {
+                Points[i].X = Coords[i*2];
+                Points[i].Y = Coords[i*2+1];
+            }
+        }
+    }
 };
 
 // ---------------------------- Path Controller
@@ -167,35 +1112,31 @@ class AGGPLUGIN_API UAGGPathController : public UObject
 
 private:
 
-    struct FConversionEntry
-    {
-        EAGGPathConv ConversionType;
-        int32 SettingIndex;
-
-        FConversionEntry() = default;
-
-        FConversionEntry(EAGGPathConv t, int32 i)
-            : ConversionType(t)
-            , SettingIndex(i)
-        {
-        }
-    };
-
-    TQueue<FConversionEntry> ConversionQueue;
-    TArray<FAGGStrokeSettings> StrokeSettings;
-    TArray<FAGGDashSettings> DashSettings;
-    TArray<FAGGCurveSettings> CurveSettings;
+    FAGGPathConversion Conversion;
 
     agg::path_storage Path;
     agg::trans_affine Transform;
 
+    // Render source baked for consumers that require path storage
+    agg::path_storage RenderPath;
+
 public:
 
+    // Renderers apply the transform while streaming the path instead of
+    // requiring ApplyTransform to modify the stored vertices
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="AGG")
+    bool bLazyTransform = false;
+
     FORCEINLINE agg::path_storage& GetAGGPath()
     {
         return Path;
     }
 
+    FORCEINLINE const agg::trans_affine& GetAGGTransform() const
+    {
+        return Transform;
+    }
+
     UFUNCTION(BlueprintCallable, Category="AGG")
     int32 Num() const
     {
@@ -229,13 +1170,13 @@ public:
     UFUNCTION(BlueprintCallable, Category="AGG")
     void ApplyTransform()
     {
-        Path.transform_all_paths(Transform);
+        FAGGPathTransform::Transform(Path, Transform);
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
     bool HasPathConversion() const
     {
-        return ! ConversionQueue.IsEmpty();
+        return ! Conversion.IsEmpty();
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
@@ -261,13 +1202,13 @@ public:
     UFUNCTION(BlueprintCallable, Category="AGG")
     void CurveTo(float x1, float y1, float x2, float y2)
     {
-        agg::curve3 curve;
+        FAGGScratchCurve3 curve;
         double x0, y0;
         Path.last_vertex(&x0, &y0);
-        curve.init(x0, y0,
+        curve->init(x0, y0,
                    x1, y1,
                    x2, y2);
-        Path.concat_path(curve);
+        Path.concat_path(*curve);
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
@@ -325,97 +1266,85 @@ public:
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
-    void PathAsStroke(FAGGStrokeSettings Settings)
+    void AddPolyline(const TArray<FVector2D>& Points, bool bClosePolygon = false)
     {
-        EAGGPathConv e = EAGGPathConv::STROKE;
-        int32 s = StrokeSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+        if (Points.Num() > 0)
+        {
+            FAGGPathBulk::AddVertices(Path, &Points[0].X, Points.Num(), bClosePolygon);
+        }
     }
 
+    // Appends closed rings, RingOffsets holds the first vertex index of
+    // each ring
     UFUNCTION(BlueprintCallable, Category="AGG")
-    void PathAsDash(FAGGDashSettings Settings)
+    void AddMultiPolygon(const TArray<FVector2D>& Vertices, const TArray<int32>& RingOffsets)
     {
-        if (Settings.DashCompositions.Num() <= 0)
-        {
-            return;
-        }
+        FAGGPathBulk::AddMultiPolygon(Path, Vertices, RingOffsets);
+    }
 
-        EAGGPathConv e = EAGGPathConv::DASH;
-        int32 s = DashSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+    // Appends Count interleaved xy pairs as one polyline
+    FORCEINLINE void AddVertices(const float* XY, int32 Count, bool bClosePolygon = false)
+    {
+        FAGGPathBulk::AddVertices(Path, XY, Count, bClosePolygon);
     }
 
-    UFUNCTION(BlueprintCallable, Category="AGG")
-    void PathAsCurve(FAGGCurveSettings Settings)
+    FORCEINLINE void AddVertices(const double* XY, int32 Count, bool bClosePolygon = false)
     {
-        EAGGPathConv e = EAGGPathConv::CURVE;
-        int32 s = CurveSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+        FAGGPathBulk::AddVertices(Path, XY, Count, bClosePolygon);
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
-    void ApplyConversion()
+    void PathAsStroke(FAGGStrokeSettings Settings)
     {
-        while (! ConversionQueue.IsEmpty())
-        {
-            FConversionEntry entry;
-            ConversionQueue.Dequeue(entry);
+        Conversion.AddStroke(Settings);
+    }
 
-            agg::path_storage p;
-            EAGGPathConv e(entry.ConversionType);
-            int32 s(entry.SettingIndex);
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void PathAsDash(FAGGDashSettings Settings)
+    {
+        Conversion.AddDash(Settings);
+    }
 
-            switch (e)
-            {
-                case EAGGPathConv::STROKE:
-                    if (StrokeSettings.IsValidIndex(s))
-                    {
-                        PathToStroke(Path, p, StrokeSettings[s]);
-                        Path = p;
-                    }
-                    break;
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void PathAsCurve(FAGGCurveSettings Settings)
+    {
+        Conversion.AddCurve(Settings);
+    }
 
-                case EAGGPathConv::DASH:
-                    if (DashSettings.IsValidIndex(s))
-                    {
-                        PathToDash(Path, p, DashSettings[s]);
-                        Path = p;
-                    }
-                    break;
+    // Offsets closed polygons by the contour width into a single outline.
+    // Filling an inflated contour matches the fill plus its outer border
+    // only if both use the same color, it does not replace a border stroke
+    // of a different color.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void PathAsContour(FAGGContourSettings Settings)
+    {
+        Conversion.AddContour(Settings);
+    }
 
-                case EAGGPathConv::CURVE:
-                    if (CurveSettings.IsValidIndex(s))
-                    {
-                        PathToCurve(Path, p, CurveSettings[s]);
-                        Path = p;
-                    }
-                    break;
-            }
-        }
+    // Reduces vertices of dense polylines, tolerance follows the transform
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void PathAsSimplify(FAGGSimplifySettings Settings)
+    {
+        Conversion.AddSimplify(Settings);
+    }
 
-        ResetConversion();
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void ApplyConversion()
+    {
+        Conversion.Apply(Path, Transform, bLazyTransform);
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
     TArray<FVector2D> ToArray(bool bApplyConversion = true)
     {
         TArray<FVector2D> points;
-        double x, y;
 
         if (bApplyConversion && HasPathConversion())
         {
             ApplyConversion();
         }
 
-        Path.rewind(0);
-        points.Reserve(Path.total_vertices());
-
-        while (! agg::is_stop(Path.vertex(&x, &y)))
-        {
-            points.Emplace(x, y);
-        }
-
-        points.Shrink();
+        FAGGPathVertexView(Path).Export(points);
 
         return MoveTemp(points);
     }
@@ -437,14 +1366,30 @@ public:
         {
             points.Emplace(x, y);
         }
+    }
+
+    // Exports vertices into separate coordinate and command arrays, the
+    // arrays keep their allocations between calls
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void ToArrays(TArray<float>& OutX, TArray<float>& OutY, TArray<uint8>& OutCommands, bool bApplyConversion = true)
+    {
+        if (bApplyConversion && HasPathConversion())
+        {
+            ApplyConversion();
+        }
+
+        FAGGPathVertexView(Path).Export(OutX, OutY, &OutCommands);
+    }
 
-        points.Shrink();
+    FORCEINLINE FAGGPathVertexView GetVertexView() const
+    {
+        return FAGGPathVertexView(Path);
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
     void ClearConversion()
     {
-        ConversionQueue.Empty();
+        Conversion.Empty();
     }
 
     UFUNCTION(BlueprintCallable, Category="AGG")
@@ -468,62 +1413,55 @@ public:
         return GetStorage();
     }
 
-private:
+    // Path with queued conversions streamed through a converter chain, the
+    // path and queue are left untouched
+    FORCEINLINE FAGGPathConversion::IVertexSource& GetConversionSource(bool bApplyTransform = false)
+    {
+        return Conversion.Compile(Path, Transform, bApplyTransform);
+    }
 
-    template<class TVertexSource>
-    void PathToStroke(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGStrokeSettings& settings)
+    // Whether renderers need the streamed source instead of the stored path
+    FORCEINLINE bool HasRenderConversion() const
     {
-        agg::conv_stroke<TVertexSource> stroke(in_vs);
-        // Apply Settings
-        stroke.width(settings.Width);
-        stroke.line_join(agg::line_join_e(settings.LineJoin));
-        stroke.line_cap(agg::line_cap_e(settings.LineCap));
-        stroke.inner_join(agg::inner_join_e(settings.InnerJoin));
-        stroke.miter_limit(settings.MiterLimit);
-        stroke.inner_miter_limit(settings.InnerMiterLimit);
-        // Concat Path
-        out_vs.concat_path(stroke);
-    }
-
-    template<class TVertexSource>
-    void PathToDash(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGDashSettings& ds)
-    {
-        const FAGGStrokeSettings& ss( ds.StrokeSettings );
-        agg::conv_dash<TVertexSource> dash(in_vs);
-        agg::conv_stroke< agg::conv_dash<TVertexSource> > stroke(dash);
-        // Apply Dash Settings
-        for (const FAGGDashComp& comp : ds.DashCompositions)
-            dash.add_dash(comp.DashLength, comp.GapLength);
-        dash.dash_start(ds.DashStart);
-        // Apply Stroke Settings
-        stroke.width(ss.Width);
-        stroke.line_join(agg::line_join_e(ss.LineJoin));
-        stroke.line_cap(agg::line_cap_e(ss.LineCap));
-        stroke.inner_join(agg::inner_join_e(ss.InnerJoin));
-        stroke.miter_limit(ss.MiterLimit);
-        stroke.inner_miter_limit(ss.InnerMiterLimit);
-        // Concat Path
-        out_vs.concat_path(stroke);
-    }
-
-    template<class TVertexSource>
-    void PathToCurve(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGCurveSettings& settings)
-    {
-        agg::conv_curve<TVertexSource> curve(in_vs);
-        // Apply Settings
-        curve.approximation_method(
-            agg::curve_approximation_method_e(settings.ApproximationMethod));
-        curve.approximation_scale(settings.ApproximationScale);
-        curve.angle_tolerance(agg::deg2rad(settings.AngleTolerance));
-        // Concat Path
-        out_vs.concat_path(curve);
+        return HasPathConversion() || (bLazyTransform && ! Transform.is_identity());
     }
 
-    void ResetConversion()
+    FORCEINLINE FAGGPathConversion::IVertexSource& GetRenderSource()
     {
-        StrokeSettings.Reset();
-        DashSettings.Reset();
-        CurveSettings.Reset();
+        return GetConversionSource(bLazyTransform);
+    }
+
+    // Render source as path storage, for consumers that record or traverse
+    // the path by id. Returns the stored path if there is nothing to
+    // convert, otherwise the source baked into scratch storage that stays
+    // valid until the next call.
+    agg::path_storage& GetRenderPath()
+    {
+        if (! HasRenderConversion())
+        {
+            return Path;
+        }
+
+        RenderPath.remove_all();
+        RenderPath.concat_path(GetRenderSource());
+
+        return RenderPath;
+    }
+
+    // Render path for consumers that apply a transform themselves. A lazy
+    // transform without queued conversions is left to the consumer through
+    // OutTransform instead of being baked, otherwise OutTransform is
+    // identity and the returned path matches what renderers draw.
+    agg::path_storage& GetRenderPath(agg::trans_affine& OutTransform)
+    {
+        if (bLazyTransform && ! HasPathConversion())
+        {
+            OutTransform = Transform;
+            return Path;
+        }
+
+        OutTransform.reset();
+        return GetRenderPath();
     }
 
 };
@@ -534,24 +1472,7 @@ class AGGPLUGIN_API FAGGPathController
 {
 private:
 
-    struct FConversionEntry
-    {
-        EAGGPathConv ConversionType;
-        int32 SettingIndex;
-
-        FConversionEntry() = default;
-
-        FConversionEntry(EAGGPathConv t, int32 i)
-            : ConversionType(t)
-            , SettingIndex(i)
-        {
-        }
-    };
-
-    TQueue<FConversionEntry> ConversionQueue;
-    TArray<FAGGStrokeSettings> StrokeSettings;
-    TArray<FAGGDashSettings> DashSettings;
-    TArray<FAGGCurveSettings> CurveSettings;
+    FAGGPathConversion Conversion;
 
     agg::path_storage Path;
     agg::trans_affine Transform;
@@ -563,6 +1484,11 @@ public:
         return Path;
     }
 
+    FORCEINLINE const agg::trans_affine& GetAGGTransform() const
+    {
+        return Transform;
+    }
+
     FORCEINLINE int32 Num() const
     {
         return Path.total_vertices();
@@ -590,12 +1516,12 @@ public:
 
     FORCEINLINE void ApplyTransform()
     {
-        Path.transform_all_paths(Transform);
+        FAGGPathTransform::Transform(Path, Transform);
     }
 
     FORCEINLINE bool HasPathConversion() const
     {
-        return ! ConversionQueue.IsEmpty();
+        return ! Conversion.IsEmpty();
     }
 
     // FLATTENED COMMAND PARAMETER
@@ -619,13 +1545,13 @@ public:
 
     FORCEINLINE void CurveTo(float x1, float y1, float x2, float y2)
     {
-        agg::curve3 curve;
+        FAGGScratchCurve3 curve;
         double x0, y0;
         Path.last_vertex(&x0, &y0);
-        curve.init(x0, y0,
+        curve->init(x0, y0,
                    x1, y1,
                    x2, y2);
-        Path.concat_path(curve);
+        Path.concat_path(*curve);
     }
 
     FORCEINLINE void Curve3(float x1, float y1, float x2, float y2)
@@ -683,13 +1609,13 @@ public:
 
     FORCEINLINE void CurveTo(const FVector2D& P1, const FVector2D& P2)
     {
-        agg::curve3 curve;
+        FAGGScratchCurve3 curve;
         double x0, y0;
         Path.last_vertex(&x0, &y0);
-        curve.init(x0, y0,
+        curve->init(x0, y0,
                    P1.X, P1.Y,
                    P2.X, P2.Y);
-        Path.concat_path(curve);
+        Path.concat_path(*curve);
     }
 
     FORCEINLINE void Curve3(const FVector2D& P1, const FVector2D& P2)
@@ -719,6 +1645,29 @@ public:
         Path.close_polygon();
     }
 
+    FORCEINLINE void AddPolyline(const TArray<FVector2D>& Points, bool bClosePolygon = false)
+    {
+        if (Points.Num() > 0)
+        {
+            FAGGPathBulk::AddVertices(Path, &Points[0].X, Points.Num(), bClosePolygon);
+        }
+    }
+
+    FORCEINLINE void AddMultiPolygon(const TArray<FVector2D>& Vertices, const TArray<int32>& RingOffsets)
+    {
+        FAGGPathBulk::AddMultiPolygon(Path, Vertices, RingOffsets);
+    }
+
+    FORCEINLINE void AddVertices(const float* XY, int32 Count, bool bClosePolygon = false)
+    {
+        FAGGPathBulk::AddVertices(Path, XY, Count, bClosePolygon);
+    }
+
+    FORCEINLINE void AddVertices(const double* XY, int32 Count, bool bClosePolygon = false)
+    {
+        FAGGPathBulk::AddVertices(Path, XY, Count, bClosePolygon);
+    }
+
     FORCEINLINE static FVector2D GetMidPoint(const FVector2D& P0, const FVector2D& P1)
     {
         return P0+(P1-P0)*.5f;
@@ -726,91 +1675,44 @@ public:
 
     inline void PathAsStroke(FAGGStrokeSettings Settings)
     {
-        EAGGPathConv e = EAGGPathConv::STROKE;
-        int32 s = StrokeSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+        Conversion.AddStroke(Settings);
     }
 
     inline void PathAsDash(FAGGDashSettings Settings)
     {
-        if (Settings.DashCompositions.Num() <= 0)
-        {
-            return;
-        }
-
-        EAGGPathConv e = EAGGPathConv::DASH;
-        int32 s = DashSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+        Conversion.AddDash(Settings);
     }
 
     inline void PathAsCurve(FAGGCurveSettings Settings)
     {
-        EAGGPathConv e = EAGGPathConv::CURVE;
-        int32 s = CurveSettings.Add(Settings);
-        ConversionQueue.Enqueue(FConversionEntry(e, s));
+        Conversion.AddCurve(Settings);
     }
 
-    void ApplyConversion()
+    inline void PathAsContour(FAGGContourSettings Settings)
     {
-        while (! ConversionQueue.IsEmpty())
-        {
-            FConversionEntry entry;
-            ConversionQueue.Dequeue(entry);
-
-            agg::path_storage p;
-            EAGGPathConv e( entry.ConversionType );
-            int32 s( entry.SettingIndex );
-
-            switch (e)
-            {
-                case EAGGPathConv::STROKE:
-                    if (StrokeSettings.IsValidIndex(s))
-                    {
-                        PathToStroke(Path, p, StrokeSettings[s]);
-                        Path = p;
-                    }
-                    break;
-
-                case EAGGPathConv::DASH:
-                    if (DashSettings.IsValidIndex(s))
-                    {
-                        PathToDash(Path, p, DashSettings[s]);
-                        Path = p;
-                    }
-                    break;
+        Conversion.AddContour(Settings);
+    }
 
-                case EAGGPathConv::CURVE:
-                    if (CurveSettings.IsValidIndex(s))
-                    {
-                        PathToCurve(Path, p, CurveSettings[s]);
-                        Path = p;
-                    }
-                    break;
-            }
-        }
+    inline void PathAsSimplify(FAGGSimplifySettings Settings)
+    {
+        Conversion.AddSimplify(Settings);
+    }
 
-        ResetConversion();
+    void ApplyConversion()
+    {
+        Conversion.Apply(Path, Transform);
     }
 
     TArray<FVector2D> ToArray(bool bApplyConversion = true)
     {
         TArray<FVector2D> points;
-        double x, y;
 
         if (bApplyConversion && HasPathConversion())
         {
             ApplyConversion();
         }
 
-        Path.rewind(0);
-        points.Reserve(Path.total_vertices());
-
-        while (! agg::is_stop(Path.vertex(&x, &y)))
-        {
-            points.Emplace(x, y);
-        }
-
-        points.Shrink();
+        FAGGPathVertexView(Path).Export(points);
 
         return MoveTemp(points);
     }
@@ -832,13 +1734,27 @@ public:
         {
             points.Emplace(x, y);
         }
+    }
+
+    template<class T>
+    void ToArrays(TArray<T>& OutX, TArray<T>& OutY, TArray<uint8>* OutCommands = nullptr, bool bApplyConversion = true)
+    {
+        if (bApplyConversion && HasPathConversion())
+        {
+            ApplyConversion();
+        }
+
+        FAGGPathVertexView(Path).Export(OutX, OutY, OutCommands);
+    }
 
-        points.Shrink();
+    FORCEINLINE FAGGPathVertexView GetVertexView() const
+    {
+        return FAGGPathVertexView(Path);
     }
 
     FORCEINLINE void ClearConversion()
     {
-        ConversionQueue.Empty();
+        Conversion.Empty();
     }
 
     FORCEINLINE void Clear()
@@ -858,62 +1774,11 @@ public:
         return GetStorage();
     }
 
-private:
-
-    template<class TVertexSource>
-    void PathToStroke(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGStrokeSettings& settings)
-    {
-        agg::conv_stroke<TVertexSource> stroke(in_vs);
-        // Apply Settings
-        stroke.width(settings.Width);
-        stroke.line_join(agg::line_join_e(settings.LineJoin));
-        stroke.line_cap(agg::line_cap_e(settings.LineCap));
-        stroke.inner_join(agg::inner_join_e(settings.InnerJoin));
-        stroke.miter_limit(settings.MiterLimit);
-        stroke.inner_miter_limit(settings.InnerMiterLimit);
-        // Concat Path
-        out_vs.concat_path(stroke);
-    }
-
-    template<class TVertexSource>
-    void PathToDash(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGDashSettings& ds)
-    {
-        const FAGGStrokeSettings& ss( ds.StrokeSettings );
-        agg::conv_dash<TVertexSource> dash(in_vs);
-        agg::conv_stroke< agg::conv_dash<TVertexSource> > stroke(dash);
-        // Apply Dash Settings
-        for (const FAGGDashComp& comp : ds.DashCompositions)
-            dash.add_dash(comp.DashLength, comp.GapLength);
-        dash.dash_start(ds.DashStart);
-        // Apply Stroke Settings
-        stroke.width(ss.Width);
-        stroke.line_join(agg::line_join_e(ss.LineJoin));
-        stroke.line_cap(agg::line_cap_e(ss.LineCap));
-        stroke.inner_join(agg::inner_join_e(ss.InnerJoin));
-        stroke.miter_limit(ss.MiterLimit);
-        stroke.inner_miter_limit(ss.InnerMiterLimit);
-        // Concat Path
-        out_vs.concat_path(stroke);
-    }
-
-    template<class TVertexSource>
-    void PathToCurve(TVertexSource& in_vs, TVertexSource& out_vs, const FAGGCurveSettings& settings)
-    {
-        agg::conv_curve<TVertexSource> curve(in_vs);
-        // Apply Settings
-        curve.approximation_method(
-            agg::curve_approximation_method_e(settings.ApproximationMethod));
-        curve.approximation_scale(settings.ApproximationScale);
-        curve.angle_tolerance(agg::deg2rad(settings.AngleTolerance));
-        // Concat Path
-        out_vs.concat_path(curve);
-    }
-
-    FORCEINLINE void ResetConversion()
+    // Path with queued conversions streamed through a converter chain, the
+    // path and queue are left untouched
+    FORCEINLINE FAGGPathConversion::IVertexSource& GetConversionSource(bool bApplyTransform = false)
     {
-        StrokeSettings.Reset();
-        DashSettings.Reset();
-        CurveSettings.Reset();
+        return Conversion.Compile(Path, Transform, bApplyTransform);
     }
 
 };
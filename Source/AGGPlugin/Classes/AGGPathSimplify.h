@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_basics.h"
+
+#include "CoreMinimal.h"
+
+// Polyline vertex reduction. Both methods keep the first and last vertex and
+// compact the vertex array in place. Scratch arrays are kept between calls.
+
+class AGGPLUGIN_API FAGGPathSimplifier
+{
+public:
+
+    struct FVertex
+    {
+        double X;
+        double Y;
+        unsigned Cmd;
+    };
+
+private:
+
+    struct FHeapEntry
+    {
+        double Area;
+        int32 Index;
+
+        FORCEINLINE bool operator<(const FHeapEntry& Other) const
+        {
+            return Area < Other.Area;
+        }
+    };
+
+    TArray<uint8> KeepMask;
+    TArray<FIntPoint> Ranges;
+    TArray<int32> Prev;
+    TArray<int32> Next;
+    TArray<double> Areas;
+    TArray<FHeapEntry> Heap;
+
+public:
+
+    // Keeps vertices farther than the tolerance from the simplified line
+    void DouglasPeucker(TArray<FVertex>& Vertices, double Tolerance)
+    {
+        const int32 Count = Vertices.Num();
+
+        if (Count < 3)
+        {
+            return;
+        }
+
+        const double ToleranceSq = Tolerance * Tolerance;
+
+        KeepMask.Reset();
+        KeepMask.AddZeroed(Count);
+        KeepMask[0] = 1;
+        KeepMask[Count-1] = 1;
+
+        Ranges.Reset();
+        Ranges.Emplace(0, Count-1);
+
+        while (Ranges.Num() > 0)
+        {
+            const FIntPoint Range( Ranges.Pop(false) );
+
+            if (Range.Y - Range.X < 2)
+            {
+                continue;
+            }
+
+            const FVertex& A( Vertices[Range.X] );
+            const FVertex& B( Vertices[Range.Y] );
+
+            double MaxDistSq = -1.0;
+            int32 MaxIndex = INDEX_NONE;
+
+            for (int32 i=Range.X+1; i<Range.Y; ++i)
+            {
+                const double DistSq = GetSegmentDistSq(Vertices[i], A, B);
+
+                if (DistSq > MaxDistSq)
+                {
+                    MaxDistSq = DistSq;
+                    MaxIndex = i;
+                }
+            }
+
+            if (MaxDistSq > ToleranceSq)
+            {
+                KeepMask[MaxIndex] = 1;
+                Ranges.Emplace(Range.X, MaxIndex);
+                Ranges.Emplace(MaxIndex, Range.Y);
+            }
+        }
+
+        Compact(Vertices);
+    }
+
+    // Removes vertices whose triangle with their neighbours has an area
+    // below the squared tolerance, smallest area first
+    void VisvalingamWhyatt(TArray<FVertex>& Vertices, double Tolerance)
+    {
+        const int32 Count = Vertices.Num();
+
+        if (Count < 3)
+        {
+            return;
+        }
+
+        const double MinArea = Tolerance * Tolerance;
+
+        KeepMask.SetNumUninitialized(Count, false);
+        Prev.SetNumUninitialized(Count, false);
+        Next.SetNumUninitialized(Count, false);
+        Areas.SetNumUninitialized(Count, false);
+        Heap.Reset();
+
+        for (int32 i=0; i<Count; ++i)
+        {
+            KeepMask[i] = 1;
+            Prev[i] = i-1;
+            Next[i] = i+1;
+        }
+
+        for (int32 i=1; i<Count-1; ++i)
+        {
+            Areas[i] = GetTriangleArea(Vertices[i-1], Vertices[i], Vertices[i+1]);
+            Heap.HeapPush({ Areas[i], i });
+        }
+
+        while (Heap.Num() > 0)
+        {
+            FHeapEntry Entry;
+            Heap.HeapPop(Entry, false);
+
+            const int32 i = Entry.Index;
+
+            // Skip removed vertices and stale areas
+            if (! KeepMask[i] || Entry.Area != Areas[i])
+            {
+                continue;
+            }
+
+            if (Entry.Area >= MinArea)
+            {
+                break;
+            }
+
+            KeepMask[i] = 0;
+
+            const int32 p = Prev[i];
+            const int32 n = Next[i];
+            Next[p] = n;
+            Prev[n] = p;
+
+            if (p > 0)
+            {
+                Areas[p] = GetTriangleArea(Vertices[Prev[p]], Vertices[p], Vertices[n]);
+                Heap.HeapPush({ Areas[p], p });
+            }
+
+            if (n < Count-1)
+            {
+                Areas[n] = GetTriangleArea(Vertices[p], Vertices[n], Vertices[Next[n]]);
+                Heap.HeapPush({ Areas[n], n });
+            }
+        }
+
+        Compact(Vertices);
+    }
+
+private:
+
+    void Compact(TArray<FVertex>& Vertices) const
+    {
+        int32 Out = 0;
+
+        for (int32 i=0; i<Vertices.Num(); ++i)
+        {
+            if (KeepMask[i])
+            {
+                Vertices[Out++] = Vertices[i];
+            }
+        }
+
+        Vertices.SetNum(Out, false);
+    }
+
+    FORCEINLINE static double GetSegmentDistSq(const FVertex& P, const FVertex& A, const FVertex& B)
+    {
+        const double dx = B.X - A.X;
+        const double dy = B.Y - A.Y;
+        const double LenSq = dx*dx + dy*dy;
+
+        double t = 0.0;
+
+        if (LenSq > 0.0)
+        {
+            t = FMath::Clamp(((P.X-A.X)*dx + (P.Y-A.Y)*dy) / LenSq, 0.0, 1.0);
+        }
+
+        const double ex = A.X + t*dx - P.X;
+        const double ey = A.Y + t*dy - P.Y;
+        return ex*ex + ey*ey;
+    }
+
+    FORCEINLINE static double GetTriangleArea(const FVertex& A, const FVertex& B, const FVertex& C)
+    {
+        return FMath::Abs((B.X-A.X)*(C.Y-A.Y) - (C.X-A.X)*(B.Y-A.Y)) * .5;
+    }
+};
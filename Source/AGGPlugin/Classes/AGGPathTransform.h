@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_basics.h"
+#include "agg_path_storage.h"
+#include "agg_trans_affine.h"
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define AGG_PATH_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#else
+#define AGG_PATH_TRANSFORM_SSE2 0
+#endif
+
+// Affine transform of all path vertices, processed one vertex block at a
+// time. Vertices of commands without coordinates (end_poly, stop) are left
+// unchanged, matching path_storage::transform_all_paths.
+
+struct AGGPLUGIN_API FAGGPathTransform
+{
+    typedef agg::path_storage::container_type FStorage;
+
+    static void Transform(agg::path_storage& Path, const agg::trans_affine& Mtx)
+    {
+        if (Mtx.is_identity())
+        {
+            return;
+        }
+
+        FStorage& Storage( Path.vertices() );
+        const int32 Count = Storage.total_vertices();
+
+        for (int32 Offset=0, b=0; Offset<Count; Offset+=FStorage::block_size, ++b)
+        {
+            const int32 BlockNum = FMath::Min(Count-Offset, int32(FStorage::block_size));
+            double* Coords = Storage.block_coords(b);
+            const agg::int8u* Commands = Storage.block_commands(b);
+
+            TransformBlock(Coords, Commands, BlockNum, Mtx);
+        }
+    }
+
+    // Transforms interleaved xy coordinates, skipping non-vertex commands.
+    // Blocks holding only vertices, the common case, take an unfiltered loop.
+    static void TransformBlock(double* RESTRICT Coords, const agg::int8u* RESTRICT Commands, int32 Count, const agg::trans_affine& Mtx)
+    {
+        bool bAllVertices = true;
+
+        for (int32 i=0; i<Count; ++i)
+        {
+            bAllVertices &= agg::is_vertex(Commands[i]);
+        }
+
+        if (! bAllVertices)
+        {
+            for (int32 i=0; i<Count; ++i)
+            {
+                if (agg::is_vertex(Commands[i]))
+                {
+                    TransformScalar(Coords + i*2, Mtx);
+                }
+            }
+            return;
+        }
+
+        int32 i = 0;
+
+#if AGG_PATH_TRANSFORM_SSE2
+        // Two vertices per iteration, x and y lanes are transformed separately
+        const __m128d Sx  = _mm_set1_pd(Mtx.sx);
+        const __m128d Shx = _mm_set1_pd(Mtx.shx);
+        const __m128d Shy = _mm_set1_pd(Mtx.shy);
+        const __m128d Sy  = _mm_set1_pd(Mtx.sy);
+        const __m128d Tx  = _mm_set1_pd(Mtx.tx);
+        const __m128d Ty  = _mm_set1_pd(Mtx.ty);
+
+        for (; i+1<Count; i+=2)
+        {
+            double* P = Coords + i*2;
+            const __m128d P0 = _mm_loadu_pd(P);
+            const __m128d P1 = _mm_loadu_pd(P+2);
+            const __m128d X = _mm_unpacklo_pd(P0, P1);
+            const __m128d Y = _mm_unpackhi_pd(P0, P1);
+            const __m128d NX = _mm_add_pd(_mm_add_pd(_mm_mul_pd(X, Sx),  _mm_mul_pd(Y, Shx)), Tx);
+            const __m128d NY = _mm_add_pd(_mm_add_pd(_mm_mul_pd(X, Shy), _mm_mul_pd(Y, Sy)),  Ty);
+            _mm_storeu_pd(P,   _mm_unpacklo_pd(NX, NY));
+            _mm_storeu_pd(P+2, _mm_unpackhi_pd(NX, NY));
+        }
+#endif
+
+        for (; i<Count; ++i)
+        {
+            TransformScalar(Coords + i*2, Mtx);
+        }
+    }
+
+    FORCEINLINE static void TransformScalar(double* P, const agg::trans_affine& Mtx)
+    {
+        const double x = P[0];
+        const double y = P[1];
+        P[0] = x*Mtx.sx  + y*Mtx.shx + Mtx.tx;
+        P[1] = x*Mtx.shy + y*Mtx.sy  + Mtx.ty;
+    }
+};
@@ -32,9 +32,55 @@
 #include "UnrealMathUtility.h"
 #include "GenericPlatformMath.h"
 #include "SharedPointer.h"
+#include "Containers/ArrayView.h"
 #include "Engine/Texture2D.h"
 
 #include "AGGTypes.h"
+#include "AGGBufferStorage.h"
+
+// Union of modified pixel bounds, max is exclusive. Used where rendered
+// bounds are collected away from the buffer, e.g. by render jobs.
+
+struct FAGGDirtyRect
+{
+    FIntRect Rect;
+    bool bValid = false;
+
+    FORCEINLINE void Reset()
+    {
+        Rect = FIntRect();
+        bValid = false;
+    }
+
+    // Adds inclusive pixel bounds
+    void Add(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+    {
+        if (MinX > MaxX || MinY > MaxY)
+        {
+            return;
+        }
+
+        const FIntRect InRect(MinX, MinY, MaxX+1, MaxY+1);
+
+        if (bValid)
+        {
+            Rect.Union(InRect);
+        }
+        else
+        {
+            Rect = InRect;
+            bValid = true;
+        }
+    }
+
+    FORCEINLINE void Add(const FAGGDirtyRect& Other)
+    {
+        if (Other.bValid)
+        {
+            Add(Other.Rect.Min.X, Other.Rect.Min.Y, Other.Rect.Max.X-1, Other.Rect.Max.Y-1);
+        }
+    }
+};
 
 class AGGPLUGIN_API IAGGRenderBuffer
 {
@@ -44,8 +90,10 @@ public:
     typedef TArray<uint8> FByteBuffer;
     typedef uint8* FRawBuffer;
 
-    // Apply default virtual destructor
-	virtual ~IAGGRenderBuffer() = default;
+	virtual ~IAGGRenderBuffer()
+    {
+        DetachTexture();
+    }
 
     virtual void InitPixFmt() = 0;
 
@@ -53,10 +101,8 @@ public:
     {
         check(InBufferW > 1 || InBufferH > 1);
 
-        if (IsValid())
-        {
-            Reset();
-        }
+        // Keep owned storage, it is reused if large enough
+        DetachTexture();
 
         InitPixFmt();
 
@@ -68,29 +114,196 @@ public:
             BufferWidth = d;
             BufferHeight = d;
         }
+        else
+        {
+            BufferWidth = InBufferW;
+            BufferHeight = InBufferH;
+        }
 
-        BufferWidth = InBufferW;
-        BufferHeight = InBufferH;
+        BufferStride = Align(BufferWidth*BufferBPP, StrideAlignment);
 
-        Buffer.SetNumZeroed(CalcBufferSize());
-        AGGBuffer.attach(Buffer.GetData(), BufferWidth, BufferHeight, GetStride());
+        BufferData = Storage.Allocate(CalcBufferSize());
+        AGGBuffer.attach(BufferData, BufferWidth, BufferHeight, GetStride());
+        ClearDirtyRect();
         Clear(InClearVal);
     }
 
 	virtual void Reset()
     {
-        Buffer.Empty();
+        DetachTexture();
+        Storage.Release();
+        BufferData = nullptr;
         BufferWidth = -1;
         BufferHeight = -1;
+        BufferStride = 0;
         BufferBPP = -1;
         AGGBuffer = agg::rendering_buffer();
+        ClearDirtyRect();
+    }
+
+    // Texture Target Operations
+
+    // Attaches the buffer directly to locked texture mip memory. Renderers
+    // write into the texture data without a staging copy until the texture
+    // is detached. Owned storage is kept and restored on detach. Renderers
+    // have to be re-attached after this call.
+    bool AttachTexture(UTexture2D* Tex, int32 MipLevel=0)
+    {
+        if (! Tex || ! Tex->PlatformData || ! Tex->PlatformData->Mips.IsValidIndex(MipLevel))
+        {
+            return false;
+        }
+
+        DetachTexture();
+        InitPixFmt();
+
+        if (GPixelFormats[Tex->GetPixelFormat()].BlockBytes != BufferBPP)
+        {
+            return false;
+        }
+
+        FTexture2DMipMap& Mip( Tex->PlatformData->Mips[MipLevel] );
+        const int32 MipW = Mip.SizeX;
+        const int32 MipH = Mip.SizeY;
+
+        if (MipW <= 0 || MipH <= 0)
+        {
+            return false;
+        }
+
+        uint8* MipData = static_cast<uint8*>( Mip.BulkData.Lock(LOCK_READ_WRITE) );
+        const int32 MipStride = Mip.BulkData.GetBulkDataSize() / MipH;
+
+        if (! MipData || MipStride < MipW*BufferBPP)
+        {
+            Mip.BulkData.Unlock();
+            return false;
+        }
+
+        SavedWidth = BufferWidth;
+        SavedHeight = BufferHeight;
+        SavedStride = BufferStride;
+        SavedDirtyRect = DirtyRect;
+        bSavedHasDirtyRect = bHasDirtyRect;
+
+        AttachedMip = &Mip;
+        BufferData = MipData;
+        BufferWidth = MipW;
+        BufferHeight = MipH;
+        BufferStride = MipStride;
+        AGGBuffer.attach(BufferData, BufferWidth, BufferHeight, GetStride());
+        ClearDirtyRect();
+
+        return true;
+    }
+
+    // Unlocks attached texture mip and restores the owned storage, if any
+    void DetachTexture()
+    {
+        if (AttachedMip)
+        {
+            AttachedMip->BulkData.Unlock();
+            AttachedMip = nullptr;
+
+            BufferData = Storage.GetData();
+            BufferWidth = SavedWidth;
+            BufferHeight = SavedHeight;
+            BufferStride = SavedStride;
+            DirtyRect = SavedDirtyRect;
+            bHasDirtyRect = bSavedHasDirtyRect;
+
+            if (IsValid())
+            {
+                AGGBuffer.attach(BufferData, BufferWidth, BufferHeight, GetStride());
+            }
+            else
+            {
+                AGGBuffer = agg::rendering_buffer();
+            }
+        }
+    }
+
+    FORCEINLINE bool IsTextureAttached() const
+    {
+        return AttachedMip != nullptr;
+    }
+
+    // Row stride alignment in bytes applied on the next Init(),
+    // 1 packs rows tightly. Storage itself is always 64-byte aligned.
+    FORCEINLINE void SetStrideAlignment(int32 InStrideAlignment)
+    {
+        check(FMath::IsPowerOfTwo(InStrideAlignment));
+        StrideAlignment = FMath::Clamp<int32>(InStrideAlignment, 1, FAGGBufferPool::Alignment);
+    }
+
+    FORCEINLINE int32 GetStrideAlignment() const
+    {
+        return StrideAlignment;
+    }
+
+    // Dirty Rect Operations
+
+    FORCEINLINE bool HasDirtyRect() const
+    {
+        return bHasDirtyRect;
+    }
+
+    // Union of modified pixels since the last upload, max is exclusive
+    FORCEINLINE const FIntRect& GetDirtyRect() const
+    {
+        return DirtyRect;
+    }
+
+    FORCEINLINE void ClearDirtyRect()
+    {
+        DirtyRect = FIntRect();
+        bHasDirtyRect = false;
+    }
+
+    FORCEINLINE void MarkDirty()
+    {
+        AddDirtyRect(0, 0, BufferWidth-1, BufferHeight-1);
+    }
+
+    // Adds inclusive pixel bounds to the dirty rect, clipped to the buffer
+    void AddDirtyRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+    {
+        MinX = FMath::Max(MinX, 0);
+        MinY = FMath::Max(MinY, 0);
+        MaxX = FMath::Min(MaxX, BufferWidth-1);
+        MaxY = FMath::Min(MaxY, BufferHeight-1);
+
+        if (MinX > MaxX || MinY > MaxY)
+        {
+            return;
+        }
+
+        const FIntRect Rect(MinX, MinY, MaxX+1, MaxY+1);
+
+        if (bHasDirtyRect)
+        {
+            DirtyRect.Union(Rect);
+        }
+        else
+        {
+            DirtyRect = Rect;
+            bHasDirtyRect = true;
+        }
+    }
+
+    FORCEINLINE void AddDirtyRect(const FAGGDirtyRect& InRect)
+    {
+        if (InRect.bValid)
+        {
+            AddDirtyRect(InRect.Rect.Min.X, InRect.Rect.Min.Y, InRect.Rect.Max.X-1, InRect.Rect.Max.Y-1);
+        }
     }
 
     // Query Operations
 
 	FORCEINLINE bool IsValid() const
     {
-        return Buffer.Num() == CalcBufferSize();
+        return BufferData != nullptr && BufferWidth > 0 && BufferHeight > 0;
     }
 
     FORCEINLINE int32 GetWidth() const
@@ -105,7 +318,7 @@ public:
 
     FORCEINLINE int32 GetStride() const
     {
-        return BufferWidth*BufferBPP;
+        return BufferStride;
     }
 
     FORCEINLINE int32 GetBPP() const
@@ -113,16 +326,29 @@ public:
         return BufferBPP;
     }
 
+    // Size of tightly packed pixel data
     FORCEINLINE SIZE_T GetBufferSize() const
     {
-        return Buffer.Num();
+        return IsValid() ? BufferHeight*GetPitch() : 0;
     }
 
+    // Size of row storage including stride padding
     FORCEINLINE int32 CalcBufferSize() const
     {
         return BufferHeight*GetStride();
     }
 
+    // Tightly packed row size
+    FORCEINLINE int32 GetPitch() const
+    {
+        return BufferWidth*BufferBPP;
+    }
+
+    FORCEINLINE bool IsPacked() const
+    {
+        return GetStride() == GetPitch();
+    }
+
     FORCEINLINE agg::rendering_buffer& GetAGGBuffer()
     {
         return AGGBuffer;
@@ -130,14 +356,46 @@ public:
 
     // Buffer Operations
 
-	FORCEINLINE const FByteBuffer& GetByteBuffer() const
+	FORCEINLINE uint8* GetData()
     {
-        return Buffer;
+        return BufferData;
     }
 
-	FORCEINLINE FByteBuffer& GetByteBuffer()
+	FORCEINLINE const uint8* GetData() const
     {
-        return Buffer;
+        return BufferData;
+    }
+
+    // Copies tightly packed pixel data to the specified byte buffer
+	void GetByteBuffer(FByteBuffer& OutBuffer) const
+    {
+        if (IsValid())
+        {
+            OutBuffer.SetNumUninitialized(GetBufferSize());
+            CopyToUnsafe(OutBuffer.GetData());
+        }
+        else
+        {
+            OutBuffer.Reset();
+        }
+    }
+
+    // Tightly packed pixel data, viewed in place if rows are packed and
+    // copied to the scratch buffer otherwise
+    TArrayView<const uint8> GetPackedView(FByteBuffer& Scratch) const
+    {
+        if (! IsValid())
+        {
+            return TArrayView<const uint8>();
+        }
+
+        if (IsPacked())
+        {
+            return TArrayView<const uint8>(BufferData, GetBufferSize());
+        }
+
+        GetByteBuffer(Scratch);
+        return TArrayView<const uint8>(Scratch);
     }
 
 	FORCEINLINE uint32 GetTypeSize() const
@@ -148,21 +406,24 @@ public:
 	FORCEINLINE uint8 GetByteAt(int32 X, int32 Y) const
     {
         return (X >= 0 && X < BufferWidth && Y >= 0 && Y < BufferHeight)
-            ? Buffer[Y*GetStride()+X*BufferBPP]
+            ? BufferData[Y*GetStride()+X*BufferBPP]
             : 0;
     }
 
 	FORCEINLINE void Clear(uint8 ClrVal)
     {
         if (IsValid())
-            FMemory::Memset(Buffer.GetData(), ClrVal, GetBufferSize());
+        {
+            FMemory::Memset(BufferData, ClrVal, CalcBufferSize());
+            MarkDirty();
+        }
     }
 
 	FORCEINLINE bool CopyFrom(FRawBuffer InBuffer)
     {
         if (IsValid())
         {
-            FMemory::Memcpy(Buffer.GetData(), InBuffer, GetBufferSize());
+            CopyFromUnsafe(InBuffer);
             return true;
         }
         return false;
@@ -170,32 +431,84 @@ public:
 
 	FORCEINLINE bool CopyFrom(const FByteBuffer& InBuffer)
     {
-        if (IsValid())
+        if (IsValid() && InBuffer.Num() >= GetBufferSize())
         {
-            FMemory::Memcpy(Buffer.GetData(), InBuffer.GetData(), GetBufferSize());
+            CopyFromUnsafe(InBuffer.GetData());
             return true;
         }
         return false;
     }
 
-	FORCEINLINE void CopyFromUnsafe(FRawBuffer InBuffer)
+    // Source data is expected to be tightly packed
+	FORCEINLINE void CopyFromUnsafe(const uint8* InBuffer)
+    {
+        if (IsPacked())
+        {
+            FMemory::Memcpy(BufferData, InBuffer, GetBufferSize());
+        }
+        else
+        {
+            const int32 Pitch = GetPitch();
+
+            for (int32 y=0; y<BufferHeight; ++y)
+            {
+                FMemory::Memcpy(BufferData+y*GetStride(), InBuffer+y*Pitch, Pitch);
+            }
+        }
+
+        MarkDirty();
+    }
+
+    // Copies pixel data of a buffer with matching dimension and format
+	bool CopyFrom(const IAGGRenderBuffer& InBuffer)
     {
-        FMemory::Memcpy(Buffer.GetData(), InBuffer, GetBufferSize());
+        if (! IsValid() || ! InBuffer.IsValid() || &InBuffer == this)
+        {
+            return false;
+        }
+
+        if (InBuffer.BufferWidth != BufferWidth || InBuffer.BufferHeight != BufferHeight || InBuffer.BufferBPP != BufferBPP)
+        {
+            return false;
+        }
+
+        const int32 Pitch = GetPitch();
+
+        for (int32 y=0; y<BufferHeight; ++y)
+        {
+            FMemory::Memcpy(BufferData+y*GetStride(), InBuffer.BufferData+y*InBuffer.GetStride(), Pitch);
+        }
+
+        MarkDirty();
+        return true;
     }
 
 	FORCEINLINE bool CopyTo(FRawBuffer OutBuffer) const
     {
         if (IsValid())
         {
-            FMemory::Memcpy(OutBuffer, Buffer.GetData(), GetBufferSize());
+            CopyToUnsafe(OutBuffer);
             return true;
         }
         return false;
     }
 
+    // Output data is written tightly packed
 	FORCEINLINE void CopyToUnsafe(FRawBuffer OutBuffer) const
     {
-        FMemory::Memcpy(OutBuffer, Buffer.GetData(), GetBufferSize());
+        if (IsPacked())
+        {
+            FMemory::Memcpy(OutBuffer, BufferData, GetBufferSize());
+        }
+        else
+        {
+            const int32 Pitch = GetPitch();
+
+            for (int32 y=0; y<BufferHeight; ++y)
+            {
+                FMemory::Memcpy(OutBuffer+y*Pitch, BufferData+y*GetStride(), Pitch);
+            }
+        }
     }
 
 	FORCEINLINE bool CopyFrom(UTexture2D* Tex, int32 MipLevel=0)
@@ -203,6 +516,10 @@ public:
         if (IsValid() && Tex)
         {
             FTexture2DMipMap& Mip( Tex->PlatformData->Mips[MipLevel] );
+            if (AttachedMip == &Mip)
+            {
+                return true;
+            }
             void* InData( Mip.BulkData.Lock(LOCK_READ_ONLY) );
             CopyFrom( static_cast<FRawBuffer>(InData) );
             Mip.BulkData.Unlock();
@@ -216,6 +533,10 @@ public:
         if (IsValid() && Tex)
         {
             FTexture2DMipMap& Mip( Tex->PlatformData->Mips[MipLevel] );
+            if (AttachedMip == &Mip)
+            {
+                return true;
+            }
             void* OutData( Mip.BulkData.Lock(LOCK_READ_WRITE) );
             CopyTo( static_cast<FRawBuffer>(OutData) );
             Mip.BulkData.Unlock();
@@ -231,14 +552,79 @@ public:
             : nullptr;
     }
 
+    // Uploads only the dirty rect to the texture resource and clears it.
+    // The texture platform data is left untouched.
+	bool UpdateTextureRegion(UTexture2D* Tex, int32 MipLevel=0)
+    {
+        if (! IsValid() || ! Tex || ! bHasDirtyRect)
+        {
+            return false;
+        }
+
+        if (Tex->GetSizeX() != BufferWidth || Tex->GetSizeY() != BufferHeight)
+        {
+            return false;
+        }
+
+        const int32 RegionX = DirtyRect.Min.X;
+        const int32 RegionY = DirtyRect.Min.Y;
+        const int32 RegionW = DirtyRect.Width();
+        const int32 RegionH = DirtyRect.Height();
+        const int32 RegionPitch = RegionW*BufferBPP;
+
+        // Copy dirty rows since the buffer may be modified before the
+        // render thread processes the update
+        uint8* RegionData = static_cast<uint8*>(FMemory::Malloc(RegionPitch*RegionH));
+        const uint8* SrcData = BufferData + RegionY*GetStride() + RegionX*BufferBPP;
+
+        for (int32 y=0; y<RegionH; ++y)
+        {
+            FMemory::Memcpy(RegionData+y*RegionPitch, SrcData+y*GetStride(), RegionPitch);
+        }
+
+        FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(RegionX, RegionY, 0, 0, RegionW, RegionH);
+
+        Tex->UpdateTextureRegions(
+            MipLevel,
+            1,
+            Region,
+            RegionPitch,
+            BufferBPP,
+            RegionData,
+            [](uint8* InData, const FUpdateTextureRegion2D* InRegions)
+            {
+                FMemory::Free(InData);
+                delete InRegions;
+            } );
+
+        ClearDirtyRect();
+
+        return true;
+    }
+
 protected:
 
-	FByteBuffer Buffer;
-	int32 BufferWidth;
-	int32 BufferHeight;
+	FAGGBufferStorage Storage;
+    uint8* BufferData = nullptr;
+	int32 BufferWidth = -1;
+	int32 BufferHeight = -1;
+    int32 BufferStride = 0;
+    int32 StrideAlignment = 1;
     int32 BufferBPP;
     agg::rendering_buffer AGGBuffer;
 
+    // Texture mip locked as render target and the owned buffer state
+    // restored when it is detached
+    FTexture2DMipMap* AttachedMip = nullptr;
+    int32 SavedWidth = -1;
+    int32 SavedHeight = -1;
+    int32 SavedStride = 0;
+    FIntRect SavedDirtyRect;
+    bool bSavedHasDirtyRect = false;
+
+    FIntRect DirtyRect;
+    bool bHasDirtyRect = false;
+
     // Hidden Constructor
 	IAGGRenderBuffer() = default;
 
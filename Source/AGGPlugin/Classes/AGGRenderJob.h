@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "SharedPointer.h"
+#include "ThreadSafeBool.h"
+#include "ScopeLock.h"
+#include "Async/Async.h"
+
+#include "AGGTypes.h"
+#include "AGGRenderBuffer.h"
+#include "AGGDrawList.h"
+#include "AGGRenderer.h"
+
+// Rasterizes a copy of a draw list into a render buffer off the game thread.
+// The job does not reference any UObject, the buffer owner has to keep the
+// buffer alive and must not read or write it until the job is complete.
+// Rendered bounds are collected in a job dirty rect, the owner merges it
+// into the buffer on the game thread.
+
+class AGGPLUGIN_API FAGGRenderJob
+{
+public:
+
+    typedef TSharedPtr<FAGGRenderJob, ESPMode::ThreadSafe> FJobPtr;
+    typedef TFunction<void(int32)> FOnComplete;
+
+    static FJobPtr Launch(
+        int32 InJobId,
+        IAGGRenderBuffer& InBuffer,
+        EAGGPixFmt InPixFmt,
+        const FAGGDrawList& InDrawList,
+        bool bInSortByState,
+        FCriticalSection& InBufferLock,
+        FOnComplete InOnComplete = FOnComplete(),
+        EAsyncExecution Execution = EAsyncExecution::ThreadPool
+        )
+    {
+        FJobPtr Job = MakeShareable(new FAGGRenderJob(InJobId, InBuffer, InPixFmt, InDrawList, bInSortByState, InBufferLock));
+        Job->OnComplete = MoveTemp(InOnComplete);
+
+        FJobPtr JobRef(Job);
+        Job->Future = Async<void>(Execution, [JobRef]()
+        {
+            JobRef->Render();
+        } );
+
+        return Job;
+    }
+
+    FORCEINLINE int32 GetJobId() const
+    {
+        return JobId;
+    }
+
+    FORCEINLINE bool IsComplete() const
+    {
+        return bComplete;
+    }
+
+    // Blocks the calling thread until the job is complete
+    void Wait() const
+    {
+        if (Future.IsValid())
+        {
+            Future.Wait();
+        }
+    }
+
+    // Adds the job dirty rect to the buffer, game thread only
+    void MergeDirtyRect()
+    {
+        check(IsInGameThread());
+        Wait();
+
+        Buffer.AddDirtyRect(DirtyRect);
+        DirtyRect.Reset();
+    }
+
+private:
+
+    int32 JobId;
+    IAGGRenderBuffer& Buffer;
+    EAGGPixFmt PixFmt;
+    FAGGDrawList DrawList;
+    bool bSortByState;
+    FCriticalSection& BufferLock;
+    FOnComplete OnComplete;
+    FAGGDirtyRect DirtyRect;
+
+    TFuture<void> Future;
+    FThreadSafeBool bComplete;
+
+    FAGGRenderJob(
+        int32 InJobId,
+        IAGGRenderBuffer& InBuffer,
+        EAGGPixFmt InPixFmt,
+        const FAGGDrawList& InDrawList,
+        bool bInSortByState,
+        FCriticalSection& InBufferLock
+        )
+        : JobId(InJobId)
+        , Buffer(InBuffer)
+        , PixFmt(InPixFmt)
+        , DrawList(InDrawList)
+        , bSortByState(bInSortByState)
+        , BufferLock(InBufferLock)
+    {
+    }
+
+    void Render()
+    {
+        {
+            // Jobs sharing a buffer are rendered one at a time
+            FScopeLock ScopeLock(&BufferLock);
+
+            FAGGDrawListRenderer Renderer;
+            Renderer.Render(Buffer, PixFmt, DrawList, bSortByState, &DirtyRect);
+        }
+
+        bComplete = true;
+
+        if (OnComplete)
+        {
+            OnComplete(JobId);
+        }
+    }
+
+    // Non-Copyable
+    FAGGRenderJob(const FAGGRenderJob&) = delete;
+    const FAGGRenderJob& operator=(const FAGGRenderJob&) = delete;
+};
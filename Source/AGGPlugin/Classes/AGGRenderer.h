@@ -36,10 +36,21 @@
 #include "agg_renderer_outline_aa.h"
 #include "agg_rasterizer_scanline_aa.h"
 #include "agg_rasterizer_outline_aa.h"
+#include "agg_rasterizer_compound_aa.h"
+#include "agg_span_allocator.h"
+#include "agg_conv_stroke.h"
+#include "agg_bounding_rect.h"
+
+#include "UniquePtr.h"
+#include "Async/ParallelFor.h"
 
 #include "AGGTypes.h"
 #include "AGGRenderBuffer.h"
 #include "AGGPathController.h"
+#include "AGGDrawList.h"
+#include "AGGShapeCache.h"
+#include "AGGIntegerPath.h"
+#include "AGGOutlineBatch.h"
 
 template<class FPixFmtType>
 class AGGPLUGIN_API TAGGRendererBase
@@ -52,6 +63,8 @@ protected:
 
     typedef agg::renderer_base<FPixFmt> FBaseRenderer;
     FPixFmt* PixFmt = nullptr;
+    IAGGRenderBuffer* RenderBuffer = nullptr;
+    FAGGDirtyRect* DirtyRectTarget = nullptr;
 
 public:
 
@@ -74,11 +87,50 @@ public:
         }
     }
 
+    // The pixel format only references the buffer, it is allocated once and
+    // rebound on later attaches
     virtual void Attach(agg::rendering_buffer& buf)
     {
-        ClearPixFmt();
-        PixFmt = new FPixFmt(buf);
+        if (PixFmt)
+        {
+            PixFmt->attach(buf);
+        }
+        else
+        {
+            PixFmt = new FPixFmt(buf);
+        }
+
         BaseRenderer.attach(*PixFmt);
+        RenderBuffer = nullptr;
+        DirtyRectTarget = nullptr;
+    }
+
+    // Attach render buffer and track rendered bounds as its dirty rect, or
+    // in the target rect if specified. Renderers off the game thread write
+    // to a target rect which the owner merges into the buffer.
+    void AttachBuffer(IAGGRenderBuffer& Buffer, FAGGDirtyRect* InDirtyRectTarget = nullptr)
+    {
+        Attach(Buffer.GetAGGBuffer());
+        RenderBuffer = &Buffer;
+        DirtyRectTarget = InDirtyRectTarget;
+    }
+
+    FORCEINLINE void AddDirtyRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY)
+    {
+        MinX = FMath::Max(MinX, BaseRenderer.xmin());
+        MinY = FMath::Max(MinY, BaseRenderer.ymin());
+        MaxX = FMath::Min(MaxX, BaseRenderer.xmax());
+        MaxY = FMath::Min(MaxY, BaseRenderer.ymax());
+
+        if (DirtyRectTarget)
+        {
+            DirtyRectTarget->Add(MinX, MinY, MaxX, MaxY);
+        }
+        else
+        if (RenderBuffer)
+        {
+            RenderBuffer->AddDirtyRect(MinX, MinY, MaxX, MaxY);
+        }
     }
 };
 
@@ -90,12 +142,147 @@ class AGGPLUGIN_API TAGGRendererScanline : public TAGGRendererBase<FPixFmtType>
 protected:
 
     typedef agg::rasterizer_scanline_aa<> FRasterizer;
+    typedef typename FRasterizer::conv_type FRasterizerConv;
+    typedef agg::rasterizer_cells_aa<agg::cell_aa> FRasterizerCells;
+
+    // Per-worker rasterization state used by banded rendering
+
+    struct FRenderBand
+    {
+        FRasterizer Rasterizer;
+        agg::scanline_p8 ScanlineP8;
+        agg::scanline_u8 ScanlineU8;
+        agg::scanline_bin ScanlineBin;
+        int32 MinY;
+        int32 MaxY;
+        int32 Cells;
+        int32 Allocations;
+        bool bOverBudget;
+    };
+
+    TArray<TUniquePtr<FRenderBand>> RenderBands;
+    int32 BandCount = 1;
+
+    // Long-lived scanlines, their span storage only grows to the widest
+    // rendered path. Rasterizer cell blocks are kept across resets as well.
+
+    agg::scanline_p8 ScanlineP8;
+    agg::scanline_u8 ScanlineU8;
+    agg::scanline_bin ScanlineBin;
+
+    FAGGRendererStorageStats StorageStats;
+    int32 ScanlineCapacity[3] = { 0, 0, 0 };
+
+    // Maximum cells per sweep, 0 uses the rasterizer cell limit
+    int32 CellBudget = 0;
+    FAGGRendererCellStats CellStats;
+    TArray<FIntPoint> CellBudgetBands;
+
+    // Rasterizer clip box applied on path reset during draw list replay
+    agg::rect_i RasterClipBox;
+    bool bRasterClip = false;
+    TArray<int32> CommandOrder;
+
+    // Draw list stroke converter, attached to the replayed draw list paths.
+    // Its generator storage is kept across replays.
+    typedef agg::conv_stroke<agg::path_storage> FReplayStroke;
+    agg::path_storage ReplayStrokeSource;
+    FReplayStroke ReplayStroke;
+
+    // Allocations made by band workers on other threads during the current
+    // allocation scope
+    int32 WorkerAllocations = 0;
+
+    // Counts AGG allocations made on the calling thread while in scope, plus
+    // those reported by band workers
+
+    struct FAllocationScope
+    {
+        FAGGRendererStorageStats& Stats;
+        int32& WorkerAllocations;
+        const unsigned StartCount;
+
+        FAllocationScope(FAGGRendererStorageStats& InStats, int32& InWorkerAllocations)
+            : Stats(InStats)
+            , WorkerAllocations(InWorkerAllocations)
+            , StartCount(agg::pod_allocation_count())
+        {
+            WorkerAllocations = 0;
+        }
+
+        ~FAllocationScope()
+        {
+            const int32 Allocations = int32(agg::pod_allocation_count() - StartCount) + WorkerAllocations;
+
+            if (Allocations > 0)
+            {
+                Stats.AllocationCount += Allocations;
+                ++Stats.AllocatingRenderCount;
+            }
+        }
+    };
 
 public:
 
     FRasterizer Rasterizer;
     agg::rgba8 Color;
 
+    TAGGRendererScanline()
+        : ReplayStroke(ReplayStrokeSource)
+    {
+    }
+
+    virtual void Attach(agg::rendering_buffer& buf) override
+    {
+        TAGGRendererBase<FPixFmtType>::Attach(buf);
+        ReserveScanlines(buf.width());
+    }
+
+    // Pre-sizes scanline storage to fit spans of the specified width
+
+    void ReserveScanlines(int32 Width)
+    {
+        if (Width <= 0)
+        {
+            return;
+        }
+
+        if (Width > ScanlineCapacity[0])
+        {
+            ScanlineP8.reset(0, Width-1);
+            ScanlineCapacity[0] = Width;
+        }
+
+        if (Width > ScanlineCapacity[1])
+        {
+            ScanlineU8.reset(0, Width-1);
+            ScanlineCapacity[1] = Width;
+        }
+
+        if (Width > ScanlineCapacity[2])
+        {
+            ScanlineBin.reset(0, Width-1);
+            ScanlineCapacity[2] = Width;
+        }
+    }
+
+    FORCEINLINE const FAGGRendererStorageStats& GetStorageStats() const
+    {
+        return StorageStats;
+    }
+
+    FORCEINLINE void GetStorageStats(FAGGRendererStorageStats& OutStats) const
+    {
+        OutStats = StorageStats;
+    }
+
+    FORCEINLINE void ResetStorageStats()
+    {
+        StorageStats.RenderCount = 0;
+        StorageStats.AllocationCount = 0;
+        StorageStats.AllocatingRenderCount = 0;
+    }
+
     FORCEINLINE void SetColor(uint8 v)
     {
         Color = agg::rgba8(v, v, v, v);
@@ -106,9 +293,50 @@ public:
         Color = agg::rgba8(c.R, c.G, c.B, c.A);
     }
 
+    // Hard rasterizer limit, cells past it are silently dropped by AGG
+    FORCEINLINE static int32 GetCellLimit()
+    {
+        return FRasterizerCells::cell_block_limit * FRasterizerCells::cell_block_size;
+    }
+
+    FORCEINLINE void SetCellBudget(int32 InCellBudget)
+    {
+        CellBudget = FMath::Max(0, InCellBudget);
+    }
+
+    FORCEINLINE int32 GetCellBudget() const
+    {
+        return CellBudget > 0 ? FMath::Min(CellBudget, GetCellLimit()) : GetCellLimit();
+    }
+
+    FORCEINLINE const FAGGRendererCellStats& GetCellStats() const
+    {
+        return CellStats;
+    }
+
+    FORCEINLINE void GetCellStats(FAGGRendererCellStats& OutStats) const
+    {
+        OutStats = CellStats;
+    }
+
+    FORCEINLINE void SetBandCount(int32 InBandCount)
+    {
+        BandCount = FMath::Max(1, InBandCount);
+    }
+
+    FORCEINLINE int32 GetBandCount() const
+    {
+        return BandCount;
+    }
+
     FORCEINLINE void ResetPath()
     {
         Rasterizer.reset_clipping();
+
+        if (bRasterClip)
+        {
+            Rasterizer.clip_box(RasterClipBox.x1, RasterClipBox.y1, RasterClipBox.x2+1, RasterClipBox.y2+1);
+        }
     }
 
     FORCEINLINE void AddPath(agg::path_storage& Path)
@@ -124,9 +352,54 @@ public:
 
     FORCEINLINE void Render(agg::path_storage& Path, FColor InColor, EAGGScanline ScanlineType)
     {
-        SetPath(Path);
+        FAllocationScope AllocationScope(StorageStats, WorkerAllocations);
+        CellStats = FAGGRendererCellStats();
+
+        if (BandCount > 1 && PixFmt)
+        {
+            SetColor(InColor);
+            RenderBanded(Path, ScanlineType);
+            return;
+        }
+
         SetColor(InColor);
+        RenderSource(Path, 0, ScanlineType);
+    }
+
+    template<class FVertexSource>
+    FORCEINLINE void RenderVertexSource(FVertexSource& Source, FColor InColor, EAGGScanline ScanlineType)
+    {
+        FAllocationScope AllocationScope(StorageStats, WorkerAllocations);
+        CellStats = FAGGRendererCellStats();
+        SetColor(InColor);
+        RenderSource(Source, 0, ScanlineType);
+    }
+
+    // Rasterizes the vertex source and renders it in a single sweep, or in
+    // clip bands if the sweep exceeds the cell budget. Cell statistics are
+    // added to the current render call.
+
+    template<class FVertexSource>
+    void RenderSource(FVertexSource& Source, unsigned PathId, EAGGScanline ScanlineType)
+    {
+        ResetPath();
+        Rasterizer.add_path(Source, PathId);
 
+        const int32 Cells = Rasterizer.total_cells();
+
+        if (Cells >= GetCellBudget() && PixFmt)
+        {
+            RenderSubdivided(Source, PathId, ScanlineType);
+            return;
+        }
+
+        AddCellStats(Cells);
+
+        RenderSweep(ScanlineType);
+    }
+
+    FORCEINLINE void RenderSweep(EAGGScanline ScanlineType)
+    {
         switch (ScanlineType)
         {
             case EAGGScanline::SL_P8:  RenderP8();  break;
@@ -137,20 +410,494 @@ public:
 
     FORCEINLINE void RenderP8()
     {
-        agg::scanline_p8 Scanline;
-        agg::render_scanlines_aa_solid(Rasterizer, Scanline, BaseRenderer, Color);
+        agg::render_scanlines_aa_solid(Rasterizer, ScanlineP8, BaseRenderer, Color);
+        UpdateStorageStats(0);
     }
 
     FORCEINLINE void RenderU8()
     {
-        agg::scanline_u8 Scanline;
-        agg::render_scanlines_aa_solid(Rasterizer, Scanline, BaseRenderer, Color);
+        agg::render_scanlines_aa_solid(Rasterizer, ScanlineU8, BaseRenderer, Color);
+        UpdateStorageStats(1);
     }
 
     FORCEINLINE void RenderBin()
     {
-        agg::scanline_bin Scanline;
-        agg::render_scanlines_bin_solid(Rasterizer, Scanline, BaseRenderer, Color);
+        agg::render_scanlines_bin_solid(Rasterizer, ScanlineBin, BaseRenderer, Color);
+        UpdateStorageStats(2);
+    }
+
+    // Feeds integer path vertices to the rasterizer in subpixel units. The
+    // subdivided fallback reads the path as a double vertex source.
+    template<class FIntegerPath>
+    void RenderIntegerPath(FIntegerPath& Path, FColor InColor, EAGGScanline ScanlineType)
+    {
+        FAllocationScope AllocationScope(StorageStats, WorkerAllocations);
+        CellStats = FAGGRendererCellStats();
+        SetColor(InColor);
+        ResetPath();
+        Path.AddTo(Rasterizer);
+
+        const int32 Cells = Rasterizer.total_cells();
+
+        if (Cells >= GetCellBudget() && PixFmt)
+        {
+            RenderSubdivided(Path, 0, ScanlineType);
+            return;
+        }
+
+        AddCellStats(Cells);
+
+        RenderSweep(ScanlineType);
+    }
+
+    // Strokes subpaths of the integer path as open polylines
+    template<class FIntegerPath>
+    void RenderIntegerStroke(FIntegerPath& Path, FColor InColor, const FAGGStrokeSettings& Settings, EAGGScanline ScanlineType)
+    {
+        typename FIntegerPath::FPolylineSource Source( Path.GetPolylineSource() );
+        agg::conv_stroke<typename FIntegerPath::FPolylineSource> Stroke(Source);
+        FAGGDrawList::ApplyStrokeSettings(Stroke, Settings);
+
+        RenderVertexSource(Stroke, InColor, ScanlineType);
+    }
+
+    // Blends cached coverage offset by integer pixels, skipping rasterization
+    void RenderCoverage(const FAGGCoverage& Coverage, FColor InColor, FIntPoint Offset)
+    {
+        if (Coverage.IsEmpty() || ! PixFmt)
+        {
+            return;
+        }
+
+        SetColor(InColor);
+        Coverage.Render(BaseRenderer, Color, Offset.X, Offset.Y);
+
+        const FIntRect& Bounds( Coverage.GetBounds() );
+        AddDirtyRect(
+            Bounds.Min.X + Offset.X,
+            Bounds.Min.Y + Offset.Y,
+            Bounds.Max.X + Offset.X,
+            Bounds.Max.Y + Offset.Y
+            );
+    }
+
+    // Replays recorded draw list commands inside the clip box, reusing a
+    // single rasterizer, scanline set and stroke converter for the whole batch
+
+    void Render(FAGGDrawList& DrawList, bool bSortByState = false)
+    {
+        const agg::rect_i ClipBox( BaseRenderer.clip_box() );
+        const FBox2D ClipBounds( GetClipBounds(ClipBox) );
+        const TArray<FAGGDrawList::FCommand>& Commands( DrawList.GetCommands() );
+
+        CommandOrder.Reset(Commands.Num());
+
+        for (int32 i=0; i<Commands.Num(); ++i)
+        {
+            if (Commands[i].Bounds.bIsValid && Commands[i].Bounds.Intersect(ClipBounds))
+            {
+                CommandOrder.Emplace(i);
+            }
+        }
+
+        RenderCommands(DrawList, ClipBox, bSortByState);
+    }
+
+    // Replays only commands intersecting the region, found through the draw
+    // list grid. Rendering is clipped to the region.
+
+    void Render(FAGGDrawList& DrawList, bool bSortByState, const FIntRect& Region)
+    {
+        const agg::rect_i ClipBox( BaseRenderer.clip_box() );
+        agg::rect_i RegionBox(Region.Min.X, Region.Min.Y, Region.Max.X-1, Region.Max.Y-1);
+
+        if (! RegionBox.clip(ClipBox))
+        {
+            return;
+        }
+
+        DrawList.Query(GetClipBounds(RegionBox), CommandOrder);
+
+        BaseRenderer.clip_box(RegionBox.x1, RegionBox.y1, RegionBox.x2, RegionBox.y2);
+        RenderCommands(DrawList, RegionBox, bSortByState);
+        BaseRenderer.clip_box(ClipBox.x1, ClipBox.y1, ClipBox.x2, ClipBox.y2);
+    }
+
+    // Splits the attached buffer into horizontal bands and renders the path
+    // on each band concurrently. Each band only receives the path edges that
+    // cross its rows, unclipped, so the generated cells for those rows are
+    // identical to the single-threaded sweep and the output is bit-exact.
+    // Bands exceeding the cell budget are subdivided on the calling thread.
+
+    void RenderBanded(agg::path_storage& Path, EAGGScanline ScanlineType)
+    {
+        const int32 ClipMinY = BaseRenderer.ymin();
+        const int32 ClipMaxY = BaseRenderer.ymax();
+        const int32 ClipH = ClipMaxY-ClipMinY+1;
+
+        if (ClipH <= 0)
+        {
+            return;
+        }
+
+        const int32 Bands = FMath::Min(BandCount, ClipH);
+        const int32 BandH = FMath::DivideAndRoundUp(ClipH, Bands);
+        const int32 Budget = GetCellBudget();
+
+        while (RenderBands.Num() < Bands)
+        {
+            RenderBands.Emplace(MakeUnique<FRenderBand>());
+        }
+
+        const unsigned CallerStartCount = agg::pod_allocation_count();
+
+        ParallelFor(Bands, [&](int32 BandIndex)
+        {
+            FRenderBand& Band( *RenderBands[BandIndex] );
+            const unsigned BandStartCount = agg::pod_allocation_count();
+
+            Band.MinY = ClipMinY + BandIndex*BandH;
+            Band.MaxY = FMath::Min(Band.MinY+BandH-1, ClipMaxY);
+
+            if (Band.MinY <= Band.MaxY)
+            {
+                RenderBand(Band, Path, Band.MinY, Band.MaxY, Budget, ScanlineType);
+            }
+            else
+            {
+                Band.Rasterizer.reset();
+                Band.Cells = 0;
+                Band.bOverBudget = false;
+            }
+
+            Band.Allocations = int32(agg::pod_allocation_count() - BandStartCount);
+        } );
+
+        // The allocation counter is per thread. Bands run on the calling
+        // thread are already counted by the enclosing allocation scope.
+
+        int32 BandAllocations = 0;
+
+        for (int32 i=0; i<Bands; ++i)
+        {
+            BandAllocations += RenderBands[i]->Allocations;
+        }
+
+        WorkerAllocations += BandAllocations - int32(agg::pod_allocation_count() - CallerStartCount);
+
+        for (int32 i=0; i<Bands; ++i)
+        {
+            const FRenderBand& Band( *RenderBands[i] );
+            const FRasterizer& BandRasterizer( Band.Rasterizer );
+
+            if (Band.bOverBudget)
+            {
+                RenderSubdivided(Path, 0, ScanlineType, Band.MinY, Band.MaxY);
+                continue;
+            }
+
+            if (Band.MinY <= Band.MaxY)
+            {
+                AddCellStats(Band.Cells);
+            }
+
+            if (BandRasterizer.total_cells() > 0)
+            {
+                AddDirtyRect(
+                    BandRasterizer.min_x(),
+                    FMath::Max(BandRasterizer.min_y(), Band.MinY),
+                    BandRasterizer.max_x(),
+                    FMath::Min(BandRasterizer.max_y(), Band.MaxY)
+                    );
+            }
+        }
+    }
+
+protected:
+
+    FORCEINLINE static FBox2D GetClipBounds(const agg::rect_i& Box)
+    {
+        return FBox2D(FVector2D(Box.x1, Box.y1), FVector2D(Box.x2+1, Box.y2+1));
+    }
+
+    // Renders the commands listed in CommandOrder with the rasterizer
+    // clipped to the box
+
+    void RenderCommands(FAGGDrawList& DrawList, const agg::rect_i& Box, bool bSortByState)
+    {
+        typedef FAGGDrawList::FCommand FCommand;
+
+        FAllocationScope AllocationScope(StorageStats, WorkerAllocations);
+        CellStats = FAGGRendererCellStats();
+
+        const TArray<FCommand>& Commands( DrawList.GetCommands() );
+        const TArray<FAGGStrokeSettings>& StrokeSettings( DrawList.GetStrokeSettings() );
+        agg::path_storage& Paths( DrawList.GetPaths() );
+
+        if (bSortByState)
+        {
+            DrawList.SortByState(CommandOrder);
+        }
+
+        RasterClipBox = Box;
+        bRasterClip = true;
+
+        ReplayStroke.attach(Paths);
+        int32 StrokeIndex = INDEX_NONE;
+
+        for (int32 i=0; i<CommandOrder.Num(); ++i)
+        {
+            const FCommand& Command( Commands[CommandOrder[i]] );
+
+            SetColor(Command.Color);
+
+            if (StrokeSettings.IsValidIndex(Command.StrokeIndex))
+            {
+                if (StrokeIndex != Command.StrokeIndex)
+                {
+                    StrokeIndex = Command.StrokeIndex;
+                    FAGGDrawList::ApplyStrokeSettings(ReplayStroke, StrokeSettings[StrokeIndex]);
+                }
+
+                RenderSource(ReplayStroke, Command.PathId, Command.ScanlineType);
+            }
+            else
+            {
+                RenderSource(Paths, Command.PathId, Command.ScanlineType);
+            }
+        }
+
+        ReplayStroke.attach(ReplayStrokeSource);
+        bRasterClip = false;
+        ResetPath();
+    }
+
+    // Renders the vertex source in horizontal clip bands, halving bands until
+    // each sweep fits the cell budget. Clipped edges are re-rounded at band
+    // seams, which may differ from a single sweep by a subpixel.
+
+    template<class FVertexSource>
+    FORCEINLINE void RenderSubdivided(FVertexSource& Source, unsigned PathId, EAGGScanline ScanlineType)
+    {
+        RenderSubdivided(Source, PathId, ScanlineType, BaseRenderer.ymin(), BaseRenderer.ymax());
+    }
+
+    // Subdivides rows [MinY, MaxY] of the clip box only
+    template<class FVertexSource>
+    void RenderSubdivided(FVertexSource& Source, unsigned PathId, EAGGScanline ScanlineType, int32 MinY, int32 MaxY)
+    {
+        const int32 Budget = GetCellBudget();
+        const agg::rect_i ClipBox( BaseRenderer.clip_box() );
+
+        CellStats.bSubdivided = true;
+
+        CellBudgetBands.Reset();
+        CellBudgetBands.Emplace(MinY, MaxY);
+
+        while (CellBudgetBands.Num() > 0)
+        {
+            const FIntPoint Band( CellBudgetBands.Pop(false) );
+
+            Rasterizer.reset();
+            Rasterizer.clip_box(ClipBox.x1, Band.X, ClipBox.x2+1, Band.Y+1);
+            Rasterizer.add_path(Source, PathId);
+
+            const int32 Cells = Rasterizer.total_cells();
+
+            if (Cells >= Budget && Band.Y > Band.X)
+            {
+                // Split band, upper half is rendered first
+                const int32 MidY = Band.X + (Band.Y-Band.X)/2;
+                CellBudgetBands.Emplace(MidY+1, Band.Y);
+                CellBudgetBands.Emplace(Band.X, MidY);
+                continue;
+            }
+
+            AddCellStats(Cells);
+
+            BaseRenderer.clip_box(ClipBox.x1, Band.X, ClipBox.x2, Band.Y);
+            RenderSweep(ScanlineType);
+        }
+
+        BaseRenderer.clip_box(ClipBox.x1, ClipBox.y1, ClipBox.x2, ClipBox.y2);
+        Rasterizer.reset_clipping();
+    }
+
+    FORCEINLINE void AddCellStats(int32 Cells)
+    {
+        ++CellStats.Bands;
+
+        if (Cells > CellStats.Cells)
+        {
+            CellStats.Cells = Cells;
+            CellStats.Blocks = FMath::DivideAndRoundUp<int32>(Cells, FRasterizerCells::cell_block_size);
+        }
+
+        if (Cells >= GetCellLimit())
+        {
+            CellStats.bTruncated = true;
+        }
+    }
+
+    // Tracks storage high-water marks of rendered sweeps, allocations are
+    // counted by the render entry points
+
+    void UpdateStorageStats(int32 ScanlineIndex)
+    {
+        ++StorageStats.RenderCount;
+
+        const int32 Cells = Rasterizer.total_cells();
+
+        if (Cells <= 0)
+        {
+            return;
+        }
+
+        AddDirtyRect(Rasterizer.min_x(), Rasterizer.min_y(), Rasterizer.max_x(), Rasterizer.max_y());
+
+        const int32 Rows = Rasterizer.max_y() - Rasterizer.min_y() + 1;
+        const int32 SpanWidth = Rasterizer.max_x() - Rasterizer.min_x() + 1;
+
+        StorageStats.MaxCells = FMath::Max(Cells, StorageStats.MaxCells);
+        StorageStats.MaxRows = FMath::Max(Rows, StorageStats.MaxRows);
+        StorageStats.MaxSpanWidth = FMath::Max(SpanWidth, StorageStats.MaxSpanWidth);
+        ScanlineCapacity[ScanlineIndex] = FMath::Max(SpanWidth, ScanlineCapacity[ScanlineIndex]);
+    }
+
+    void RenderBand(FRenderBand& Band, const agg::path_storage& Path, int32 MinY, int32 MaxY, int32 Budget, EAGGScanline ScanlineType)
+    {
+        FRasterizer& BandRasterizer( Band.Rasterizer );
+
+        BandRasterizer.reset_clipping();
+        AddPathBand(BandRasterizer, Path, MinY, MaxY);
+
+        // Left to the calling thread, cells may already be truncated
+        Band.Cells = BandRasterizer.total_cells();
+        Band.bOverBudget = Band.Cells >= Budget;
+
+        if (Band.bOverBudget)
+        {
+            return;
+        }
+
+        FBaseRenderer BandRenderer( *PixFmt );
+        BandRenderer.clip_box(BaseRenderer.xmin(), MinY, BaseRenderer.xmax(), MaxY);
+
+        switch (ScanlineType)
+        {
+            case EAGGScanline::SL_P8:
+                SweepBand(BandRasterizer, Band.ScanlineP8, BandRenderer, MinY, MaxY);
+                break;
+
+            case EAGGScanline::SL_U8:
+                SweepBand(BandRasterizer, Band.ScanlineU8, BandRenderer, MinY, MaxY);
+                break;
+
+            case EAGGScanline::SL_Bin:
+                SweepBandBin(BandRasterizer, Band.ScanlineBin, BandRenderer, MinY, MaxY);
+                break;
+        }
+    }
+
+    // Feeds path edges that touch rows [MinY, MaxY] to the rasterizer,
+    // following the same move_to / line_to / auto-close rules as
+    // rasterizer_scanline_aa::add_path().
+
+    static void AddPathBand(FRasterizer& Ras, const agg::path_storage& Path, int32 MinY, int32 MaxY)
+    {
+        const int32 SubMinY = MinY << agg::poly_subpixel_shift;
+        const int32 SubMaxY = ((MaxY+1) << agg::poly_subpixel_shift) - 1;
+        const unsigned TotalVertices = Path.total_vertices();
+
+        int32 StartX = 0, StartY = 0;
+        int32 LastX  = 0, LastY  = 0;
+        bool bHasLine = false;
+
+        for (unsigned i=0; i<TotalVertices; ++i)
+        {
+            double x, y;
+            unsigned cmd = Path.vertex(i, &x, &y);
+
+            if (agg::is_stop(cmd))
+            {
+                break;
+            }
+
+            if (agg::is_move_to(cmd))
+            {
+                if (bHasLine)
+                {
+                    AddEdgeBand(Ras, LastX, LastY, StartX, StartY, SubMinY, SubMaxY);
+                }
+
+                StartX = LastX = FRasterizerConv::upscale(x);
+                StartY = LastY = FRasterizerConv::upscale(y);
+                bHasLine = false;
+            }
+            else
+            if (agg::is_vertex(cmd))
+            {
+                const int32 X = FRasterizerConv::upscale(x);
+                const int32 Y = FRasterizerConv::upscale(y);
+                AddEdgeBand(Ras, LastX, LastY, X, Y, SubMinY, SubMaxY);
+                LastX = X;
+                LastY = Y;
+                bHasLine = true;
+            }
+            else
+            if (agg::is_close(cmd) && bHasLine)
+            {
+                AddEdgeBand(Ras, LastX, LastY, StartX, StartY, SubMinY, SubMaxY);
+                LastX = StartX;
+                LastY = StartY;
+                bHasLine = false;
+            }
+        }
+
+        if (bHasLine)
+        {
+            AddEdgeBand(Ras, LastX, LastY, StartX, StartY, SubMinY, SubMaxY);
+        }
+    }
+
+    FORCEINLINE static void AddEdgeBand(FRasterizer& Ras, int32 x1, int32 y1, int32 x2, int32 y2, int32 SubMinY, int32 SubMaxY)
+    {
+        if (FMath::Max(y1, y2) >= SubMinY && FMath::Min(y1, y2) <= SubMaxY)
+        {
+            Ras.edge(x1, y1, x2, y2);
+        }
+    }
+
+    template<class FScanline>
+    void SweepBand(FRasterizer& Ras, FScanline& Scanline, FBaseRenderer& Ren, int32 MinY, int32 MaxY)
+    {
+        if (Ras.rewind_scanlines() && Ras.navigate_scanline(FMath::Max(MinY, Ras.min_y())))
+        {
+            typename FBaseRenderer::color_type RenColor = Color;
+
+            Scanline.reset(Ras.min_x(), Ras.max_x());
+
+            while (Ras.sweep_scanline(Scanline) && Scanline.y() <= MaxY)
+            {
+                agg::render_scanline_aa_solid(Scanline, Ren, RenColor);
+            }
+        }
+    }
+
+    template<class FScanline>
+    void SweepBandBin(FRasterizer& Ras, FScanline& Scanline, FBaseRenderer& Ren, int32 MinY, int32 MaxY)
+    {
+        if (Ras.rewind_scanlines() && Ras.navigate_scanline(FMath::Max(MinY, Ras.min_y())))
+        {
+            typename FBaseRenderer::color_type RenColor = Color;
+
+            Scanline.reset(Ras.min_x(), Ras.max_x());
+
+            while (Ras.sweep_scanline(Scanline) && Scanline.y() <= MaxY)
+            {
+                agg::render_scanline_bin_solid(Scanline, Ren, RenColor);
+            }
+        }
     }
 };
 
@@ -171,26 +918,31 @@ protected:
 
 public:
 
-    FRenderer*   Renderer;
-    FRasterizer* Rasterizer;
-
-    bool        bClosePolygon;
+    bool        bClosePolygon = false;
     agg::rgba8  Color;
     agg::line_profile_aa Profile;
 
-	TAGGRendererOutline()
-    {
-        Renderer   = new FRenderer(BaseRenderer, Profile);
-        Rasterizer = new FRasterizer(*Renderer);
-    }
+    FRenderer   Renderer;
+    FRasterizer Rasterizer;
 
-	virtual ~TAGGRendererOutline()
-    {
-        check(Renderer   != nullptr);
-        check(Rasterizer != nullptr);
+protected:
+
+    // Bounds of paths added since the last render
+    double PathMinX, PathMinY, PathMaxX, PathMaxY;
+    bool bHasPathBounds = false;
+
+    // Batch line profiles keyed by subpixel width, rebuilt only when the
+    // smoother width changes
+    TMap<int32, TUniquePtr<agg::line_profile_aa>> BatchProfiles;
+    float BatchSmootherWidth = 1.f;
+    TArray<int32> BatchOrder;
 
-        delete Renderer;
-        delete Rasterizer;
+public:
+
+	TAGGRendererOutline()
+        : Renderer(BaseRenderer, Profile)
+        , Rasterizer(Renderer)
+    {
     }
 
     FORCEINLINE void SetColor(uint8 v)
@@ -213,43 +965,51 @@ public:
         Profile.smoother_width(LineProfile.SmootherWidth);
         Profile.width(LineProfile.Width);
 
+        if (BatchSmootherWidth != LineProfile.SmootherWidth)
+        {
+            BatchSmootherWidth = LineProfile.SmootherWidth;
+            BatchProfiles.Reset();
+        }
+
         switch (LineProfile.LineJoin)
         {
             case EAGGOutlineAALineJoin::OUTLINE_NO_JOIN:
-                Rasterizer->line_join(agg::outline_no_join);
+                Rasterizer.line_join(agg::outline_no_join);
                 break;
 
             case EAGGOutlineAALineJoin::OUTLINE_MITER_JOIN:
-                Rasterizer->line_join(agg::outline_miter_join);
+                Rasterizer.line_join(agg::outline_miter_join);
                 break;
 
             case EAGGOutlineAALineJoin::OUTLINE_ROUND_JOIN:
-                Rasterizer->line_join(agg::outline_round_join);
+                Rasterizer.line_join(agg::outline_round_join);
                 break;
 
             case EAGGOutlineAALineJoin::OUTLINE_MITER_ACCURATE_JOIN:
-                Rasterizer->line_join(agg::outline_miter_accurate_join);
+                Rasterizer.line_join(agg::outline_miter_accurate_join);
                 break;
         }
 
-        Rasterizer->round_cap(LineProfile.bRoundCap);
+        Rasterizer.round_cap(LineProfile.bRoundCap);
     }
 
     FORCEINLINE void AddPath(agg::path_storage& Path)
     {
-        Rasterizer->add_path(Path);
+        Renderer.color(Color);
+        Rasterizer.add_path(Path);
+        AddPathBounds(Path);
     }
 
     FORCEINLINE void AddPath(agg::path_storage& Path, bool bInClosePolygon)
     {
-        Rasterizer->add_path(Path);
+        AddPath(Path);
         SetClosePolygon(bInClosePolygon);
     }
 
     FORCEINLINE void Render(agg::path_storage& Path, FColor InColor, bool bInClosePolygon)
     {
-        AddPath(Path);
         SetColor(InColor);
+        AddPath(Path);
         SetClosePolygon(bInClosePolygon);
         Render();
     }
@@ -262,7 +1022,287 @@ public:
 
     FORCEINLINE void Render()
     {
-        Rasterizer->render(bClosePolygon);
+        Renderer.color(Color);
+        Rasterizer.render(bClosePolygon);
+        FlushPathBounds(Profile.subpixel_width());
+    }
+
+    // Renders each subpath of the vertex source as an open polyline unless
+    // the source closes it explicitly
+    template<class FVertexSource>
+    void RenderPolyline(FVertexSource& Source, FColor InColor)
+    {
+        SetColor(InColor);
+        Renderer.color(Color);
+        Rasterizer.add_path(Source);
+        AddPathBounds(Source);
+        FlushPathBounds(Profile.subpixel_width());
+    }
+
+    // Renders batch lines in recorded order, binding the cached line profile
+    // and color only when they change. Sorting by state groups lines by width
+    // and color, which changes the painter order of overlapping lines. Line
+    // joins and caps follow the current line profile.
+    void Render(FAGGOutlineBatch& Batch, bool bSortByState = false)
+    {
+        const TArray<FAGGOutlineBatch::FLine>& Lines( Batch.GetLines() );
+        agg::path_storage& Paths( Batch.GetPaths() );
+
+        if (Lines.Num() == 0)
+        {
+            return;
+        }
+
+        BatchOrder.Reset(Lines.Num());
+
+        for (int32 i=0; i<Lines.Num(); ++i)
+        {
+            BatchOrder.Emplace(i);
+        }
+
+        if (bSortByState)
+        {
+            BatchOrder.StableSort( [&Lines](const int32& i0, const int32& i1) {
+                const int32 w0 = GetProfileKey(Lines[i0].Width);
+                const int32 w1 = GetProfileKey(Lines[i1].Width);
+                return (w0 != w1) ? (w0 < w1) : (Lines[i0].Color.DWColor() < Lines[i1].Color.DWColor());
+            } );
+        }
+
+        int32 ProfileKey = INDEX_NONE;
+        int32 MaxSubpixelWidth = 0;
+        FColor LineColor;
+
+        for (int32 i=0; i<BatchOrder.Num(); ++i)
+        {
+            const FAGGOutlineBatch::FLine& Line( Lines[BatchOrder[i]] );
+            const int32 Key = GetProfileKey(Line.Width);
+
+            if (Key != ProfileKey || i == 0)
+            {
+                agg::line_profile_aa& LineProfile( FindOrAddProfile(Key) );
+                Renderer.profile(LineProfile);
+                MaxSubpixelWidth = FMath::Max(MaxSubpixelWidth, LineProfile.subpixel_width());
+                ProfileKey = Key;
+            }
+
+            if (Line.Color != LineColor || i == 0)
+            {
+                LineColor = Line.Color;
+                Renderer.color(agg::rgba8(LineColor.R, LineColor.G, LineColor.B, LineColor.A));
+            }
+
+            Rasterizer.add_path(Paths, Line.PathId);
+            AddPathBounds(Paths, Line.PathId);
+        }
+
+        Renderer.profile(Profile);
+        FlushPathBounds(MaxSubpixelWidth);
+    }
+
+    FORCEINLINE int32 GetBatchProfileCount() const
+    {
+        return BatchProfiles.Num();
+    }
+
+protected:
+
+    FORCEINLINE static int32 GetProfileKey(float Width)
+    {
+        return agg::iround(FMath::Max(0.f, Width) * agg::line_subpixel_scale);
+    }
+
+    agg::line_profile_aa& FindOrAddProfile(int32 Key)
+    {
+        if (TUniquePtr<agg::line_profile_aa>* Found = BatchProfiles.Find(Key))
+        {
+            return **Found;
+        }
+
+        agg::line_profile_aa* LineProfile = new agg::line_profile_aa;
+        LineProfile->smoother_width(BatchSmootherWidth);
+        LineProfile->width(double(Key) / agg::line_subpixel_scale);
+        BatchProfiles.Emplace(Key, TUniquePtr<agg::line_profile_aa>(LineProfile));
+
+        return *LineProfile;
+    }
+
+    template<class FVertexSource>
+    void AddPathBounds(FVertexSource& Path, unsigned PathId = 0)
+    {
+        if (! RenderBuffer)
+        {
+            return;
+        }
+
+        double x1, y1, x2, y2;
+
+        if (agg::bounding_rect_single(Path, PathId, &x1, &y1, &x2, &y2))
+        {
+            if (bHasPathBounds)
+            {
+                PathMinX = FMath::Min(PathMinX, x1);
+                PathMinY = FMath::Min(PathMinY, y1);
+                PathMaxX = FMath::Max(PathMaxX, x2);
+                PathMaxY = FMath::Max(PathMaxY, y2);
+            }
+            else
+            {
+                PathMinX = x1;
+                PathMinY = y1;
+                PathMaxX = x2;
+                PathMaxY = y2;
+                bHasPathBounds = true;
+            }
+        }
+    }
+
+    void FlushPathBounds(int32 SubpixelWidth)
+    {
+        if (bHasPathBounds)
+        {
+            // Expand by line profile extent, rounded outward
+            const double Extent = double(SubpixelWidth) / agg::line_subpixel_scale + 2.0;
+
+            AddDirtyRect(
+                FMath::FloorToInt(PathMinX - Extent),
+                FMath::FloorToInt(PathMinY - Extent),
+                FMath::CeilToInt(PathMaxX + Extent),
+                FMath::CeilToInt(PathMaxY + Extent)
+                );
+
+            bHasPathBounds = false;
+        }
+    }
+};
+
+// Renderer Compound
+
+template<class FPixFmtType>
+class AGGPLUGIN_API TAGGRendererCompound : public TAGGRendererBase<FPixFmtType>
+{
+protected:
+
+    typedef typename FPixFmtType::color_type FColorType;
+
+    // Solid color per style index, unassigned styles render transparent
+
+    struct FStyleHandler
+    {
+        TArray<FColorType> Colors;
+        FColorType Transparent;
+
+        FStyleHandler()
+            : Transparent(agg::rgba8(0, 0, 0, 0))
+        {
+        }
+
+        FORCEINLINE bool is_solid(unsigned Style) const
+        {
+            return true;
+        }
+
+        FORCEINLINE const FColorType& color(unsigned Style) const
+        {
+            return Colors.IsValidIndex(Style) ? Colors[Style] : Transparent;
+        }
+
+        void generate_span(FColorType* Span, int x, int y, unsigned Len, unsigned Style)
+        {
+            // Solid styles only
+        }
+    };
+
+    agg::scanline_u8 ScanlineAA;
+    agg::scanline_bin ScanlineBin;
+    agg::span_allocator<FColorType> SpanAllocator;
+    FStyleHandler StyleHandler;
+
+public:
+
+    agg::rasterizer_compound_aa<> Rasterizer;
+
+    virtual void Attach(agg::rendering_buffer& buf) override
+    {
+        TAGGRendererBase<FPixFmtType>::Attach(buf);
+        Rasterizer.clip_box(0, 0, buf.width(), buf.height());
+    }
+
+    FORCEINLINE void SetColor(uint8 v)
+    {
+        SetStyleColor(0, FColor(v, v, v, v));
+    }
+
+    FORCEINLINE void SetColor(FColor c)
+    {
+        SetStyleColor(0, c);
+    }
+
+    void SetStyleColor(int32 Style, FColor c)
+    {
+        check(Style >= 0);
+
+        if (Style >= StyleHandler.Colors.Num())
+        {
+            StyleHandler.Colors.SetNum(Style+1);
+
+            for (int32 i=Style; i<StyleHandler.Colors.Num(); ++i)
+            {
+                StyleHandler.Colors[i] = StyleHandler.Transparent;
+            }
+        }
+
+        StyleHandler.Colors[Style] = FColorType(agg::rgba8(c.R, c.G, c.B, c.A));
+    }
+
+    FORCEINLINE void ResetPath()
+    {
+        Rasterizer.reset();
+    }
+
+    // Style colors are kept across ResetPath()
+    FORCEINLINE void ResetStyles()
+    {
+        StyleHandler.Colors.Reset();
+    }
+
+    // Adds a filled path with the specified style. Edges shared with other
+    // styles get their coverage split exactly between both styles.
+    FORCEINLINE void AddPath(agg::path_storage& Path, int32 Style = 0)
+    {
+        Rasterizer.styles(Style, -1);
+        Rasterizer.add_path(Path);
+    }
+
+    FORCEINLINE void AddPath(agg::path_storage& Path, int32 Style, FColor InColor)
+    {
+        SetStyleColor(Style, InColor);
+        AddPath(Path, Style);
+    }
+
+    FORCEINLINE void Render(agg::path_storage& Path, FColor InColor)
+    {
+        ResetPath();
+        AddPath(Path, 0, InColor);
+        Render();
+    }
+
+    // Renders all added paths in a single sweep and resets the rasterizer
+    void Render()
+    {
+        if (Rasterizer.rewind_scanlines())
+        {
+            const int32 MinX = Rasterizer.min_x();
+            const int32 MinY = Rasterizer.min_y();
+            const int32 MaxX = Rasterizer.max_x();
+            const int32 MaxY = Rasterizer.max_y();
+
+            agg::render_scanlines_compound(Rasterizer, ScanlineAA, ScanlineBin, BaseRenderer, SpanAllocator, StyleHandler);
+
+            AddDirtyRect(MinX, MinY, MaxX, MaxY);
+        }
+
+        Rasterizer.reset();
     }
 };
 
@@ -285,3 +1325,99 @@ class AGGPLUGIN_API FAGGRendererOutlinePlainBGRA    : public TAGGRendererOutline
 class AGGPLUGIN_API FAGGRendererOutlineAlphaBlendR  : public TAGGRendererOutline<FAGGPFAlphaBlendR> { };
 class AGGPLUGIN_API FAGGRendererOutlineAlphaBlendG  : public TAGGRendererOutline<FAGGPFAlphaBlendG> { };
 class AGGPLUGIN_API FAGGRendererOutlineAlphaBlendB  : public TAGGRendererOutline<FAGGPFAlphaBlendB> { };
+
+// Typed Renderers - Renderer Compound
+
+class AGGPLUGIN_API FAGGRendererCompoundG8          : public TAGGRendererCompound<FAGGPFG8>     { };
+class AGGPLUGIN_API FAGGRendererCompoundBGRA        : public TAGGRendererCompound<FAGGPFBGRA32> { };
+class AGGPLUGIN_API FAGGRendererCompoundPlainBGRA   : public TAGGRendererCompound<FAGGPFBGRA32_Plain> { };
+
+class AGGPLUGIN_API FAGGRendererCompoundAlphaBlendR : public TAGGRendererCompound<FAGGPFAlphaBlendR> { };
+class AGGPLUGIN_API FAGGRendererCompoundAlphaBlendG : public TAGGRendererCompound<FAGGPFAlphaBlendG> { };
+class AGGPLUGIN_API FAGGRendererCompoundAlphaBlendB : public TAGGRendererCompound<FAGGPFAlphaBlendB> { };
+
+// Draw List Renderer
+
+class AGGPLUGIN_API FAGGDrawListRenderer
+{
+private:
+
+    struct IReplay
+    {
+        virtual ~IReplay() = default;
+        virtual void Render(IAGGRenderBuffer& Buffer, FAGGDrawList& DrawList, bool bSortByState, const FIntRect* Region, FAGGDirtyRect* DirtyRect) = 0;
+    };
+
+    template<class FPixFmt>
+    struct TReplay : public IReplay
+    {
+        TAGGRendererScanline<FPixFmt> Renderer;
+
+        virtual void Render(IAGGRenderBuffer& Buffer, FAGGDrawList& DrawList, bool bSortByState, const FIntRect* Region, FAGGDirtyRect* DirtyRect) override
+        {
+            Renderer.AttachBuffer(Buffer, DirtyRect);
+
+            if (Region)
+            {
+                Renderer.Render(DrawList, bSortByState, *Region);
+            }
+            else
+            {
+                Renderer.Render(DrawList, bSortByState);
+            }
+        }
+    };
+
+    TUniquePtr<IReplay> Replay;
+    EAGGPixFmt ReplayPixFmt = EAGGPixFmt::PF_Unknown;
+
+public:
+
+    // Rendered bounds are added to the buffer dirty rect, or to the target
+    // rect if specified
+    void Render(IAGGRenderBuffer& Buffer, EAGGPixFmt PixFmt, FAGGDrawList& DrawList, bool bSortByState = false, FAGGDirtyRect* DirtyRect = nullptr)
+    {
+        RenderReplay(Buffer, PixFmt, DrawList, bSortByState, nullptr, DirtyRect);
+    }
+
+    // Only commands intersecting the region are rasterized
+    void Render(IAGGRenderBuffer& Buffer, EAGGPixFmt PixFmt, FAGGDrawList& DrawList, bool bSortByState, const FIntRect& Region, FAGGDirtyRect* DirtyRect = nullptr)
+    {
+        RenderReplay(Buffer, PixFmt, DrawList, bSortByState, &Region, DirtyRect);
+    }
+
+private:
+
+    void RenderReplay(IAGGRenderBuffer& Buffer, EAGGPixFmt PixFmt, FAGGDrawList& DrawList, bool bSortByState, const FIntRect* Region, FAGGDirtyRect* DirtyRect)
+    {
+        if (! Buffer.IsValid() || DrawList.Num() <= 0)
+        {
+            return;
+        }
+
+        if (PixFmt != ReplayPixFmt)
+        {
+            Replay.Reset();
+            ReplayPixFmt = EAGGPixFmt::PF_Unknown;
+
+            switch (PixFmt)
+            {
+                case EAGGPixFmt::PF_G8:          Replay = MakeUnique< TReplay<FAGGPFG8>          >(); break;
+                case EAGGPixFmt::PF_BGRA32:      Replay = MakeUnique< TReplay<FAGGPFBGRA32>      >(); break;
+                case EAGGPixFmt::PF_AlphaBlendR: Replay = MakeUnique< TReplay<FAGGPFAlphaBlendR> >(); break;
+                case EAGGPixFmt::PF_AlphaBlendG: Replay = MakeUnique< TReplay<FAGGPFAlphaBlendG> >(); break;
+                case EAGGPixFmt::PF_AlphaBlendB: Replay = MakeUnique< TReplay<FAGGPFAlphaBlendB> >(); break;
+            }
+
+            if (Replay.IsValid())
+            {
+                ReplayPixFmt = PixFmt;
+            }
+        }
+
+        if (Replay.IsValid())
+        {
+            Replay->Render(Buffer, DrawList, bSortByState, Region, DirtyRect);
+        }
+    }
+};
@@ -33,8 +33,40 @@
 #include "AGGTypes.h"
 #include "AGGContext.h"
 #include "AGGRenderer.h"
+#include "AGGShapeCacheObject.h"
+#include "AGGIntegerPathObject.h"
 #include "AGGRendererObject.generated.h"
 
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGOutlineBatchEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite)
+    UAGGPathController* Path = nullptr;
+
+	UPROPERTY(BlueprintReadWrite)
+    float Width = 1.f;
+
+	UPROPERTY(BlueprintReadWrite)
+    FColor Color;
+};
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGCompoundEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite)
+    UAGGPathController* Path = nullptr;
+
+	UPROPERTY(BlueprintReadWrite)
+    int32 Style = 0;
+
+	UPROPERTY(BlueprintReadWrite)
+    FColor Color;
+};
+
 UCLASS(BlueprintType)
 class AGGPLUGIN_API UAGGScanlineRenderer : public UObject
 {
@@ -112,6 +144,9 @@ public:
 #define AGG_TYPED_RENDERER_CALL_THREE_PARAM(TypeName, PixelFormat, Method, Param1, Param2, Param3) \
     AGG_TYPED_RENDERER_SWITCH(TypeName, PixelFormat, GetRenderer, -> Method(Param1, Param2, Param3))
 
+#define AGG_TYPED_RENDERER_CALL_FOUR_PARAM(TypeName, PixelFormat, Method, Param1, Param2, Param3, Param4) \
+    AGG_TYPED_RENDERER_SWITCH(TypeName, PixelFormat, GetRenderer, -> Method(Param1, Param2, Param3, Param4))
+
 UCLASS(Abstract, BlueprintType)
 class AGGPLUGIN_API UAGGRendererBase : public UObject
 {
@@ -121,6 +156,8 @@ protected:
 
     void* UntypedRenderer = nullptr;
     EAGGPixFmt PixFmt = EAGGPixFmt::PF_Unknown;
+    TWeakObjectPtr<UAGGContext> AttachedContext;
+    int32 AttachedGeneration = 0;
 
 public:
 
@@ -170,6 +207,38 @@ public:
 
 protected:
 
+    // Waits for render jobs of the attached context, which write the same
+    // buffer, and follows buffer swaps and re-allocations of the context.
+    // Called before any renderer access to buffer memory.
+    FORCEINLINE void PrepareBufferAccess()
+    {
+        if (UAGGContext* Context = AttachedContext.Get())
+        {
+            Context->WaitAllRenderJobs();
+
+            if (AttachedGeneration != Context->GetBufferGeneration())
+            {
+                AttachBuffer(Context);
+            }
+        }
+    }
+
+    template<template<typename> class FRenderer>
+    void AttachContextTyped(UAGGContext* Context)
+    {
+        if (IsValid(Context))
+        {
+            Context->WaitAllRenderJobs();
+
+            if (IAGGRenderBuffer* Buffer = Context->GetRenderBuffer())
+            {
+                AttachBufferTyped<FRenderer>(*Buffer);
+                AttachedContext = Context;
+                AttachedGeneration = Context->GetBufferGeneration();
+            }
+        }
+    }
+
     template<template<typename> class FRenderer>
     void ResetRendererTyped()
     {
@@ -225,6 +294,15 @@ protected:
         }
     }
 
+    template<template<typename> class FRenderer>
+    void AttachBufferTyped(IAGGRenderBuffer& Buffer)
+    {
+        if (UntypedRenderer)
+        {
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, AttachBuffer, Buffer)
+        }
+    }
+
     template<template<typename> class FRenderer>
     void SetColorTyped(const FColor& Color)
     {
@@ -278,6 +356,15 @@ public:
     UPROPERTY(BlueprintReadWrite)
     FColor Color;
 
+    // Number of horizontal bands rendered concurrently, 1 renders on the calling thread
+    UPROPERTY(BlueprintReadOnly)
+    int32 BandCount = 1;
+
+    // Maximum rasterizer cells per sweep before a render is split into clip
+    // bands, 0 uses the rasterizer cell limit
+    UPROPERTY(BlueprintReadOnly)
+    int32 CellBudget = 0;
+
     virtual void ResetRenderer() override
     {
         ResetRendererTyped<FRenderer>();
@@ -288,6 +375,8 @@ public:
     void CreateRenderer(EAGGPixFmt InPixFmt, UAGGContext* Context = nullptr)
     {
         CreateRendererTyped<FRenderer>(InPixFmt);
+        SetBandCount(BandCount);
+        SetCellBudget(CellBudget);
 
         if (IsValid(Context))
         {
@@ -297,12 +386,17 @@ public:
 
     virtual void AttachBuffer(UAGGContext* Context) override
     {
-        if (IsValid(Context))
+        AttachContextTyped<FRenderer>(Context);
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void SetBandCount(int32 InBandCount)
+    {
+        BandCount = FMath::Max(1, InBandCount);
+
+        if (UntypedRenderer)
         {
-            if (IAGGRenderBuffer* Buffer = Context->GetBuffer())
-            {
-                AttachBufferTyped<FRenderer>(Buffer->GetAGGBuffer());
-            }
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, SetBandCount, BandCount);
         }
     }
 
@@ -318,6 +412,46 @@ public:
         Color = FColor(InValue, InValue, InValue, InValue);
     }
 
+    UFUNCTION(BlueprintCallable)
+    void SetCellBudget(int32 InCellBudget)
+    {
+        CellBudget = FMath::Max(0, InCellBudget);
+
+        if (UntypedRenderer)
+        {
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, SetCellBudget, CellBudget);
+        }
+    }
+
+    // Cell statistics of the last render call, accumulated over all
+    // commands of a draw list replay
+    UFUNCTION(BlueprintCallable)
+    FAGGRendererCellStats GetCellStats()
+    {
+        FAGGRendererCellStats Stats;
+
+        if (UntypedRenderer)
+        {
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, GetCellStats, Stats);
+        }
+
+        return Stats;
+    }
+
+    // AllocationCount stays constant once rendering reaches steady state
+    UFUNCTION(BlueprintCallable)
+    FAGGRendererStorageStats GetStorageStats()
+    {
+        FAGGRendererStorageStats Stats;
+
+        if (UntypedRenderer)
+        {
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, GetStorageStats, Stats);
+        }
+
+        return Stats;
+    }
+
     UFUNCTION(BlueprintCallable)
     void ResetPath()
     {
@@ -329,31 +463,115 @@ public:
     {
         if (IsValid(PathController))
         {
-            AddPathTyped<FRenderer>(PathController->GetAGGPath());
+            AddPathTyped<FRenderer>(PathController->GetRenderPath());
         }
     }
 
+    // Paths with queued conversions or a lazy transform are streamed through
+    // the conversion chain, the path itself is left unconverted
     UFUNCTION(BlueprintCallable)
     void RenderPath(UAGGPathController* Path, FColor InColor, EAGGScanline Scanline = EAGGScanline::SL_Unknown)
     {
         if (UntypedRenderer && IsValid(Path))
         {
+            PrepareBufferAccess();
+
             if (Scanline == EAGGScanline::SL_Unknown)
             {
                 Scanline = ScanlineType;
             }
 
-            AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, Render, Path->GetAGGPath(), InColor, Scanline);
+            if (Path->HasRenderConversion())
+            {
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, RenderVertexSource, Path->GetRenderSource(), InColor, Scanline);
+            }
+            else
+            {
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, Render, Path->GetRenderPath(), InColor, Scanline);
+            }
         }
     }
 
-    virtual void Render(UAGGPathController* Path) override
+    UFUNCTION(BlueprintCallable)
+    void RenderIntegerPath(UAGGIntegerPath* Path, FColor InColor, EAGGScanline Scanline = EAGGScanline::SL_Unknown)
+    {
+        if (UntypedRenderer && IsValid(Path))
+        {
+            PrepareBufferAccess();
+
+            if (Scanline == EAGGScanline::SL_Unknown)
+            {
+                Scanline = ScanlineType;
+            }
+
+            if (Path->Format == EAGGIntegerPathFormat::IPF_Int16)
+            {
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, RenderIntegerPath, Path->GetPath16(), InColor, Scanline);
+            }
+            else
+            {
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, RenderIntegerPath, Path->GetPath32(), InColor, Scanline);
+            }
+        }
+    }
+
+    // Strokes the integer path subpaths as open polylines
+    UFUNCTION(BlueprintCallable)
+    void RenderIntegerStroke(UAGGIntegerPath* Path, FColor InColor, const FAGGStrokeSettings& Settings, EAGGScanline Scanline = EAGGScanline::SL_Unknown)
     {
         if (UntypedRenderer && IsValid(Path))
         {
-            AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, Render, Path->GetAGGPath(), Color, ScanlineType);
+            PrepareBufferAccess();
+
+            if (Scanline == EAGGScanline::SL_Unknown)
+            {
+                Scanline = ScanlineType;
+            }
+
+            if (Path->Format == EAGGIntegerPathFormat::IPF_Int16)
+            {
+                AGG_TYPED_RENDERER_CALL_FOUR_PARAM(FRenderer, PixFmt, RenderIntegerStroke, Path->GetPath16(), InColor, Settings, Scanline);
+            }
+            else
+            {
+                AGG_TYPED_RENDERER_CALL_FOUR_PARAM(FRenderer, PixFmt, RenderIntegerStroke, Path->GetPath32(), InColor, Settings, Scanline);
+            }
         }
     }
+
+    // Renders the path through the shape cache. The path is rasterized with
+    // its transform on first use, later calls only blend the cached spans.
+    // Each call hashes the path, prefer RenderShape() for repeated stamps.
+    UFUNCTION(BlueprintCallable)
+    void RenderCachedPath(UAGGShapeCache* Cache, UAGGPathController* Path, FColor InColor, FIntPoint Offset)
+    {
+        if (UntypedRenderer && IsValid(Cache) && IsValid(Path))
+        {
+            FAGGShapeCache::FCoveragePtr Coverage( Cache->FindOrAdd(Path) );
+
+            if (Coverage.IsValid())
+            {
+                PrepareBufferAccess();
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, RenderCoverage, *Coverage, InColor, Offset);
+            }
+        }
+    }
+
+    // Blends cached coverage obtained from UAGGShapeCache::GetHandle()
+    UFUNCTION(BlueprintCallable)
+    void RenderShape(const FAGGShapeHandle& Handle, FColor InColor, FIntPoint Offset)
+    {
+        if (UntypedRenderer && Handle.IsValid())
+        {
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, RenderCoverage, *Handle.Coverage, InColor, Offset);
+        }
+    }
+
+    virtual void Render(UAGGPathController* Path) override
+    {
+        RenderPath(Path, Color, ScanlineType);
+    }
 };
 
 UCLASS(BlueprintType)
@@ -364,6 +582,8 @@ class AGGPLUGIN_API UAGGRendererOutlineAA : public UAGGRendererBase
     template <class FPixFmt>
     using FRenderer = TAGGRendererOutline<FPixFmt>;
 
+    FAGGOutlineBatch Batch;
+
 public:
 
     UPROPERTY(BlueprintReadWrite)
@@ -377,13 +597,7 @@ public:
 
     virtual void AttachBuffer(UAGGContext* Context) override
     {
-        if (IsValid(Context))
-        {
-            if (IAGGRenderBuffer* Buffer = Context->GetBuffer())
-            {
-                AttachBufferTyped<FRenderer>(Buffer->GetAGGBuffer());
-            }
-        }
+        AttachContextTyped<FRenderer>(Context);
     }
 
     virtual void SetColor(FColor InColor) override
@@ -432,7 +646,8 @@ public:
     {
         if (UntypedRenderer && IsValid(Path))
         {
-            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, AddPath, Path->GetAGGPath(), bClosePolygon);
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, AddPath, Path->GetRenderPath(), bClosePolygon);
         }
     }
 
@@ -441,15 +656,194 @@ public:
     {
         if (UntypedRenderer && IsValid(Path))
         {
-            AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, Render, Path->GetAGGPath(), InColor, bClosePolygon);
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, Render, Path->GetRenderPath(), InColor, bClosePolygon);
+        }
+    }
+
+    // Renders the integer path subpaths as open polylines
+    UFUNCTION(BlueprintCallable)
+    void RenderIntegerPolyline(UAGGIntegerPath* Path, FColor InColor)
+    {
+        if (UntypedRenderer && IsValid(Path))
+        {
+            PrepareBufferAccess();
+
+            if (Path->Format == EAGGIntegerPathFormat::IPF_Int16)
+            {
+                FAGGIntegerPath16::FPolylineSource Source( Path->GetPath16().GetPolylineSource() );
+                AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, RenderPolyline, Source, InColor);
+            }
+            else
+            {
+                FAGGIntegerPath32::FPolylineSource Source( Path->GetPath32().GetPolylineSource() );
+                AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, RenderPolyline, Source, InColor);
+            }
+        }
+    }
+
+    // Renders all entries in array order, or grouped by width and color if
+    // sorted by state. Line joins and caps follow the current line profile.
+    UFUNCTION(BlueprintCallable)
+    void RenderBatch(const TArray<FAGGOutlineBatchEntry>& Entries, bool bSortByState = false)
+    {
+        if (! UntypedRenderer)
+        {
+            return;
         }
+
+        Batch.Reset();
+
+        for (const FAGGOutlineBatchEntry& Entry : Entries)
+        {
+            if (IsValid(Entry.Path))
+            {
+                Batch.AddPath(Entry.Path->GetRenderPath(), Entry.Width, Entry.Color);
+            }
+        }
+
+        RenderOutlineBatch(Batch, bSortByState);
+    }
+
+    void RenderOutlineBatch(FAGGOutlineBatch& InBatch, bool bSortByState = false)
+    {
+        if (UntypedRenderer)
+        {
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, Render, InBatch, bSortByState);
+        }
+    }
+
+    virtual void Render(UAGGPathController* Path) override
+    {
+        if (UntypedRenderer && IsValid(Path))
+        {
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, Render, Path->GetRenderPath());
+        }
+    }
+};
+
+UCLASS(BlueprintType)
+class AGGPLUGIN_API UAGGRendererCompound : public UAGGRendererBase
+{
+	GENERATED_BODY()
+
+    template <class FPixFmt>
+    using FRenderer = TAGGRendererCompound<FPixFmt>;
+
+public:
+
+    UPROPERTY(BlueprintReadWrite)
+    FColor Color;
+
+    virtual void ResetRenderer() override
+    {
+        ResetRendererTyped<FRenderer>();
+        UAGGRendererBase::ResetRenderer();
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void CreateRenderer(EAGGPixFmt InPixFmt, UAGGContext* Context = nullptr)
+    {
+        CreateRendererTyped<FRenderer>(InPixFmt);
+
+        if (IsValid(Context))
+        {
+            AttachBuffer(Context);
+        }
+    }
+
+    virtual void AttachBuffer(UAGGContext* Context) override
+    {
+        AttachContextTyped<FRenderer>(Context);
+    }
+
+    virtual void SetColor(FColor InColor) override
+    {
+        SetColorTyped<FRenderer>(InColor);
+        Color = InColor;
+    }
+
+    virtual void SetColorByte(uint8 InValue) override
+    {
+        SetColorTyped<FRenderer>(InValue);
+        Color = FColor(InValue, InValue, InValue, InValue);
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void SetStyleColor(int32 Style, FColor InColor)
+    {
+        if (UntypedRenderer && Style >= 0)
+        {
+            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, SetStyleColor, Style, InColor);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void ResetStyles()
+    {
+        if (UntypedRenderer)
+        {
+            AGG_TYPED_RENDERER_CALL(FRenderer, PixFmt, ResetStyles);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void ResetPath()
+    {
+        ResetPathTyped<FRenderer>();
+    }
+
+    UFUNCTION(BlueprintCallable)
+    void AddPath(UAGGPathController* Path, int32 Style = 0)
+    {
+        if (UntypedRenderer && IsValid(Path) && Style >= 0)
+        {
+            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, AddPath, Path->GetRenderPath(), Style);
+        }
+    }
+
+    // Renders all paths added since the last render in a single sweep
+    UFUNCTION(BlueprintCallable)
+    void RenderCompound()
+    {
+        if (UntypedRenderer)
+        {
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL(FRenderer, PixFmt, Render);
+        }
+    }
+
+    // Renders entries in a single sweep, cost scales with covered pixels
+    // instead of the number of entries
+    UFUNCTION(BlueprintCallable)
+    void RenderEntries(const TArray<FAGGCompoundEntry>& Entries)
+    {
+        if (! UntypedRenderer)
+        {
+            return;
+        }
+
+        ResetPath();
+
+        for (const FAGGCompoundEntry& Entry : Entries)
+        {
+            if (IsValid(Entry.Path) && Entry.Style >= 0)
+            {
+                AGG_TYPED_RENDERER_CALL_THREE_PARAM(FRenderer, PixFmt, AddPath, Entry.Path->GetRenderPath(), Entry.Style, Entry.Color);
+            }
+        }
+
+        RenderCompound();
     }
 
     virtual void Render(UAGGPathController* Path) override
     {
         if (UntypedRenderer && IsValid(Path))
         {
-            AGG_TYPED_RENDERER_CALL_ONE_PARAM(FRenderer, PixFmt, Render, Path->GetAGGPath());
+            PrepareBufferAccess();
+            AGG_TYPED_RENDERER_CALL_TWO_PARAM(FRenderer, PixFmt, Render, Path->GetRenderPath(), Color);
         }
     }
 };
@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_path_storage.h"
+#include "agg_trans_affine.h"
+#include "agg_conv_transform.h"
+#include "agg_rasterizer_scanline_aa.h"
+#include "agg_scanline_u.h"
+#include "agg_scanline_storage_aa.h"
+#include "agg_renderer_scanline.h"
+
+#include "SharedPointer.h"
+#include "Hash/CityHash.h"
+#include "Misc/Crc.h"
+
+// Serialized scanline coverage of a rasterized path. Replaying the coverage
+// only blends the stored spans, no rasterization is involved.
+
+class AGGPLUGIN_API FAGGCoverage
+{
+public:
+
+    typedef agg::serialized_scanlines_adaptor_aa8 FAdaptor;
+
+    FAGGCoverage() = default;
+
+    // Serializes rendered scanline storage, returns false if it is empty
+    bool Build(agg::scanline_storage_aa8& Storage)
+    {
+        ResetView();
+        Data.Reset();
+        Bounds = FIntRect();
+
+        if (! Storage.rewind_scanlines())
+        {
+            return false;
+        }
+
+        Data.SetNumUninitialized(Storage.byte_size());
+        Storage.serialize(Data.GetData());
+
+        DataPtr = Data.GetData();
+        DataSize = Data.Num();
+        Bounds = FIntRect(Storage.min_x(), Storage.min_y(), Storage.max_x(), Storage.max_y());
+
+        return true;
+    }
+
+    // References serialized coverage owned by a loaded coverage file. The
+    // data has to be validated and outlive the coverage.
+    void SetView(const uint8* InData, int32 InDataSize, const FIntRect& InBounds)
+    {
+        Data.Empty();
+        DataPtr = InData;
+        DataSize = InDataSize;
+        Bounds = InBounds;
+        bView = true;
+    }
+
+    FORCEINLINE bool IsView() const
+    {
+        return bView;
+    }
+
+    FORCEINLINE bool IsEmpty() const
+    {
+        return DataSize == 0;
+    }
+
+    FORCEINLINE const uint8* GetData() const
+    {
+        return DataPtr;
+    }
+
+    FORCEINLINE int32 GetDataSize() const
+    {
+        return DataSize;
+    }
+
+    // Inclusive pixel bounds of the coverage
+    FORCEINLINE const FIntRect& GetBounds() const
+    {
+        return Bounds;
+    }
+
+    FORCEINLINE SIZE_T GetAllocatedSize() const
+    {
+        return Data.GetAllocatedSize();
+    }
+
+    // Blends the coverage offset by integer pixels
+    template<class FBaseRenderer, class FColorType>
+    void Render(FBaseRenderer& Renderer, const FColorType& Color, int32 OffsetX, int32 OffsetY) const
+    {
+        if (! IsEmpty())
+        {
+            FAdaptor Adaptor(DataPtr, DataSize, OffsetX, OffsetY);
+            FAdaptor::embedded_scanline Scanline;
+            agg::render_scanlines_aa_solid(Adaptor, Scanline, Renderer, Color);
+        }
+    }
+
+private:
+
+    TArray<uint8> Data;
+    const uint8* DataPtr = nullptr;
+    int32 DataSize = 0;
+    FIntRect Bounds;
+    bool bView = false;
+
+    FORCEINLINE void ResetView()
+    {
+        DataPtr = nullptr;
+        DataSize = 0;
+        bView = false;
+    }
+
+    // Non-Copyable
+    FAGGCoverage(const FAGGCoverage&) = delete;
+    const FAGGCoverage& operator=(const FAGGCoverage&) = delete;
+};
+
+// Coverage cache keyed by path content and transform. Keys combine two
+// independent hashes of the vertex data, callers stamping the same shape
+// repeatedly should keep the returned coverage instead of looking it up.
+
+class AGGPLUGIN_API FAGGShapeCache
+{
+public:
+
+    typedef TSharedPtr<const FAGGCoverage, ESPMode::ThreadSafe> FCoveragePtr;
+
+    struct FKey
+    {
+        uint64 Hash = 0;
+        uint32 Crc = 0;
+        int32 NumVertices = 0;
+
+        FORCEINLINE bool operator==(const FKey& Other) const
+        {
+            return Hash == Other.Hash && Crc == Other.Crc && NumVertices == Other.NumVertices;
+        }
+
+        friend FORCEINLINE uint32 GetTypeHash(const FKey& Key)
+        {
+            return static_cast<uint32>(Key.Hash) ^ static_cast<uint32>(Key.Hash >> 32);
+        }
+    };
+
+    FKey MakeKey(const agg::path_storage& Path, const agg::trans_affine& Transform)
+    {
+        const unsigned VertexCount = Path.total_vertices();
+
+        KeyData.Reset(VertexCount*3 + 6);
+
+        for (unsigned i=0; i<VertexCount; ++i)
+        {
+            double x, y;
+            const unsigned Cmd = Path.vertex(i, &x, &y);
+            KeyData.Emplace(x);
+            KeyData.Emplace(y);
+            KeyData.Emplace(static_cast<double>(Cmd));
+        }
+
+        double Matrix[6];
+        Transform.store_to(Matrix);
+        KeyData.Append(Matrix, 6);
+
+        const int32 KeyDataSize = KeyData.Num()*sizeof(double);
+
+        FKey Key;
+        Key.Hash = CityHash64(reinterpret_cast<const char*>(KeyData.GetData()), KeyDataSize);
+        Key.Crc = FCrc::MemCrc32(KeyData.GetData(), KeyDataSize);
+        Key.NumVertices = VertexCount;
+
+        return Key;
+    }
+
+    FORCEINLINE FCoveragePtr Find(const FKey& Key) const
+    {
+        const FCoveragePtr* Coverage = Entries.Find(Key);
+        return Coverage ? *Coverage : FCoveragePtr();
+    }
+
+    // Returns cached coverage of the transformed path, rasterizing it on miss
+    FCoveragePtr FindOrAdd(agg::path_storage& Path, const agg::trans_affine& Transform = agg::trans_affine())
+    {
+        const FKey Key( MakeKey(Path, Transform) );
+
+        if (const FCoveragePtr* Coverage = Entries.Find(Key))
+        {
+            return *Coverage;
+        }
+
+        agg::conv_transform<agg::path_storage> TransformedPath(Path, Transform);
+
+        Rasterizer.reset();
+        Rasterizer.add_path(TransformedPath);
+        agg::render_scanlines(Rasterizer, Scanline, Storage);
+
+        TSharedPtr<FAGGCoverage, ESPMode::ThreadSafe> Coverage( MakeShareable(new FAGGCoverage()) );
+        Coverage->Build(Storage);
+
+        Add(Key, Coverage);
+
+        return Coverage;
+    }
+
+    FORCEINLINE void Add(const FKey& Key, FCoveragePtr Coverage)
+    {
+        if (Coverage.IsValid())
+        {
+            Entries.Emplace(Key, Coverage);
+        }
+    }
+
+    FORCEINLINE void Reserve(int32 Count)
+    {
+        Entries.Reserve(Entries.Num() + Count);
+    }
+
+    FORCEINLINE bool Remove(const FKey& Key)
+    {
+        return Entries.Remove(Key) > 0;
+    }
+
+    FORCEINLINE void Empty()
+    {
+        Entries.Empty();
+    }
+
+    FORCEINLINE int32 Num() const
+    {
+        return Entries.Num();
+    }
+
+    FORCEINLINE const TMap<FKey, FCoveragePtr>& GetEntries() const
+    {
+        return Entries;
+    }
+
+    SIZE_T GetAllocatedSize() const
+    {
+        SIZE_T Size = Entries.GetAllocatedSize();
+
+        for (const TPair<FKey, FCoveragePtr>& Entry : Entries)
+        {
+            Size += Entry.Value->GetAllocatedSize();
+        }
+
+        return Size;
+    }
+
+private:
+
+    TMap<FKey, FCoveragePtr> Entries;
+
+    // Reused build state
+    agg::rasterizer_scanline_aa<> Rasterizer;
+    agg::scanline_u8 Scanline;
+    agg::scanline_storage_aa8 Storage;
+    TArray<double> KeyData;
+};
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreUObject.h"
+
+#include "AGGShapeCache.h"
+#include "AGGCoverageFile.h"
+#include "AGGPathController.h"
+#include "AGGShapeCacheObject.generated.h"
+
+// Resolved cache entry, stamping by handle skips key hashing and lookup.
+// The handle keeps its coverage alive after the cache is emptied.
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGShapeHandle
+{
+	GENERATED_BODY()
+
+    FAGGShapeCache::FCoveragePtr Coverage;
+
+    FORCEINLINE bool IsValid() const
+    {
+        return Coverage.IsValid() && ! Coverage->IsEmpty();
+    }
+};
+
+UCLASS(BlueprintType)
+class AGGPLUGIN_API UAGGShapeCache : public UObject
+{
+	GENERATED_BODY()
+
+    FAGGShapeCache Cache;
+
+public:
+
+    FORCEINLINE FAGGShapeCache& GetCache()
+    {
+        return Cache;
+    }
+
+    // Returns cached coverage of the path with its current transform
+    FAGGShapeCache::FCoveragePtr FindOrAdd(UAGGPathController* Path)
+    {
+        if (! IsValid(Path))
+        {
+            return FAGGShapeCache::FCoveragePtr();
+        }
+
+        agg::trans_affine Transform;
+        agg::path_storage& RenderPath( Path->GetRenderPath(Transform) );
+        return Cache.FindOrAdd(RenderPath, Transform);
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool Precache(UAGGPathController* Path)
+    {
+        return GetHandle(Path).IsValid();
+    }
+
+    // Returns a handle to the cached coverage of the path with its current
+    // transform, rasterizing it on miss
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    FAGGShapeHandle GetHandle(UAGGPathController* Path)
+    {
+        FAGGShapeHandle Handle;
+        Handle.Coverage = FindOrAdd(Path);
+        return Handle;
+    }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="AGG")
+    static bool IsValidHandle(const FAGGShapeHandle& Handle)
+    {
+        return Handle.IsValid();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 Num() const
+    {
+        return Cache.Num();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Empty()
+    {
+        Cache.Empty();
+    }
+
+    // Writes cached coverage to a versioned binary file
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool SaveToFile(const FString& Filename) const
+    {
+        return FAGGCoverageFile::Save(Filename, Cache);
+    }
+
+    // Adds coverage stored in the file to the cache. Entries reference the
+    // memory-mapped file data, no coverage is copied or rasterized.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool LoadFromFile(const FString& Filename)
+    {
+        FAGGCoverageFile::FFilePtr File( FAGGCoverageFile::Load(Filename) );
+
+        if (File.IsValid())
+        {
+            File->AddToCache(Cache);
+            return true;
+        }
+
+        return false;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 GetAllocatedSize() const
+    {
+        return static_cast<int32>(Cache.GetAllocatedSize());
+    }
+};
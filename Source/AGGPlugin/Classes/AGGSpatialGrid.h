@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Uniform grid over item bounding boxes. Items are referenced by index, each
+// cell lists the items overlapping it in a single packed array.
+
+class AGGPLUGIN_API FAGGSpatialGrid
+{
+    enum { MaxDim = 1024 };
+
+    FBox2D GridBounds;
+    FVector2D InvCellSize;
+    int32 Dim = 0;
+
+    TArray<FBox2D> ItemBounds;
+    TArray<int32> CellStart;
+    TArray<int32> CellItems;
+
+    // Per item query stamp, filters items overlapping several cells
+    TArray<uint32> ItemStamps;
+    uint32 QueryStamp = 0;
+
+public:
+
+    FAGGSpatialGrid()
+        : GridBounds(ForceInit)
+        , InvCellSize(0.f, 0.f)
+    {
+    }
+
+    FORCEINLINE bool IsEmpty() const
+    {
+        return Dim == 0;
+    }
+
+    FORCEINLINE int32 GetDim() const
+    {
+        return Dim;
+    }
+
+    void Reset()
+    {
+        GridBounds.Init();
+        Dim = 0;
+        ItemBounds.Reset();
+        CellStart.Reset();
+        CellItems.Reset();
+        ItemStamps.Reset();
+        QueryStamp = 0;
+    }
+
+    // Builds the grid with about one cell per item. Items with invalid
+    // bounds are never returned by queries.
+    template<class FGetBounds>
+    void Build(int32 NumItems, FGetBounds GetBounds)
+    {
+        Reset();
+
+        ItemBounds.SetNumUninitialized(NumItems);
+
+        for (int32 i=0; i<NumItems; ++i)
+        {
+            ItemBounds[i] = GetBounds(i);
+
+            if (ItemBounds[i].bIsValid)
+            {
+                GridBounds += ItemBounds[i];
+            }
+        }
+
+        if (! GridBounds.bIsValid)
+        {
+            return;
+        }
+
+        Dim = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt(float(NumItems))), 1, int32(MaxDim));
+
+        const FVector2D Size( GridBounds.GetSize() );
+        InvCellSize.X = Size.X > KINDA_SMALL_NUMBER ? Dim / Size.X : 0.f;
+        InvCellSize.Y = Size.Y > KINDA_SMALL_NUMBER ? Dim / Size.Y : 0.f;
+
+        // Count items per cell, then turn counts into offsets
+
+        CellStart.SetNumZeroed(Dim*Dim + 1);
+
+        for (int32 i=0; i<NumItems; ++i)
+        {
+            if (ItemBounds[i].bIsValid)
+            {
+                FIntRect Range( GetCellRange(ItemBounds[i]) );
+
+                for (int32 y=Range.Min.Y; y<=Range.Max.Y; ++y)
+                for (int32 x=Range.Min.X; x<=Range.Max.X; ++x)
+                {
+                    ++CellStart[y*Dim + x + 1];
+                }
+            }
+        }
+
+        for (int32 c=1; c<CellStart.Num(); ++c)
+        {
+            CellStart[c] += CellStart[c-1];
+        }
+
+        TArray<int32> CellCursor( CellStart );
+        CellItems.SetNumUninitialized(CellStart.Last());
+
+        for (int32 i=0; i<NumItems; ++i)
+        {
+            if (ItemBounds[i].bIsValid)
+            {
+                FIntRect Range( GetCellRange(ItemBounds[i]) );
+
+                for (int32 y=Range.Min.Y; y<=Range.Max.Y; ++y)
+                for (int32 x=Range.Min.X; x<=Range.Max.X; ++x)
+                {
+                    CellItems[CellCursor[y*Dim + x]++] = i;
+                }
+            }
+        }
+
+        ItemStamps.SetNumZeroed(NumItems);
+    }
+
+    // Indices of items whose bounds intersect the region, in ascending order
+    void Query(const FBox2D& Region, TArray<int32>& OutIndices)
+    {
+        OutIndices.Reset();
+
+        if (IsEmpty() || ! Region.bIsValid || ! GridBounds.Intersect(Region))
+        {
+            return;
+        }
+
+        if (++QueryStamp == 0)
+        {
+            FMemory::Memzero(ItemStamps.GetData(), ItemStamps.Num() * ItemStamps.GetTypeSize());
+            QueryStamp = 1;
+        }
+
+        FIntRect Range( GetCellRange(Region) );
+
+        for (int32 y=Range.Min.Y; y<=Range.Max.Y; ++y)
+        for (int32 x=Range.Min.X; x<=Range.Max.X; ++x)
+        {
+            const int32 c = y*Dim + x;
+
+            for (int32 i=CellStart[c]; i<CellStart[c+1]; ++i)
+            {
+                const int32 Item = CellItems[i];
+
+                if (ItemStamps[Item] != QueryStamp)
+                {
+                    ItemStamps[Item] = QueryStamp;
+
+                    if (ItemBounds[Item].Intersect(Region))
+                    {
+                        OutIndices.Emplace(Item);
+                    }
+                }
+            }
+        }
+
+        OutIndices.Sort();
+    }
+
+private:
+
+    FORCEINLINE int32 GetCell(float V, float Origin, float InvSize) const
+    {
+        return FMath::Clamp(FMath::FloorToInt((V-Origin) * InvSize), 0, Dim-1);
+    }
+
+    // Inclusive cell range covered by the box
+    FORCEINLINE FIntRect GetCellRange(const FBox2D& Box) const
+    {
+        return FIntRect(
+            GetCell(Box.Min.X, GridBounds.Min.X, InvCellSize.X),
+            GetCell(Box.Min.Y, GridBounds.Min.Y, InvCellSize.Y),
+            GetCell(Box.Max.X, GridBounds.Min.X, InvCellSize.X),
+            GetCell(Box.Max.Y, GridBounds.Min.Y, InvCellSize.Y)
+            );
+    }
+};
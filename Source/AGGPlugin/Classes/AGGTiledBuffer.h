@@ -0,0 +1,444 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "agg_basics.h"
+#include "agg_path_storage.h"
+#include "agg_scanline_p.h"
+#include "agg_scanline_u.h"
+#include "agg_scanline_bin.h"
+#include "agg_renderer_base.h"
+#include "agg_renderer_scanline.h"
+#include "agg_rasterizer_scanline_aa.h"
+
+#include "UniquePtr.h"
+
+#include "AGGTypes.h"
+#include "AGGRenderBuffer.h"
+
+// Sparse canvas split into square tiles. Tile buffers are allocated on first
+// write, untouched regions have no storage.
+
+class AGGPLUGIN_API IAGGTiledBuffer
+{
+public:
+
+    enum { DefaultTileSize = 256 };
+
+    typedef TMap<FIntPoint, TUniquePtr<IAGGRenderBuffer>> FTileMap;
+
+	virtual ~IAGGTiledBuffer() = default;
+
+	void Init(int32 InCanvasW, int32 InCanvasH, int32 InTileSize = DefaultTileSize, uint8 InClearVal = 0)
+    {
+        check(InCanvasW > 0 && InCanvasH > 0);
+        check(InTileSize > 1);
+
+        Reset();
+
+        CanvasWidth = InCanvasW;
+        CanvasHeight = InCanvasH;
+        TileSize = InTileSize;
+        ClearVal = InClearVal;
+    }
+
+	void Reset()
+    {
+        Tiles.Empty();
+        CanvasWidth = 0;
+        CanvasHeight = 0;
+    }
+
+    FORCEINLINE bool IsValid() const
+    {
+        return CanvasWidth > 0 && CanvasHeight > 0;
+    }
+
+    FORCEINLINE int32 GetWidth() const
+    {
+        return CanvasWidth;
+    }
+
+    FORCEINLINE int32 GetHeight() const
+    {
+        return CanvasHeight;
+    }
+
+    FORCEINLINE int32 GetTileSize() const
+    {
+        return TileSize;
+    }
+
+    FORCEINLINE int32 GetTileCountX() const
+    {
+        return (CanvasWidth+TileSize-1) / TileSize;
+    }
+
+    FORCEINLINE int32 GetTileCountY() const
+    {
+        return (CanvasHeight+TileSize-1) / TileSize;
+    }
+
+    FORCEINLINE int32 GetAllocatedTileCount() const
+    {
+        return Tiles.Num();
+    }
+
+    FORCEINLINE const FTileMap& GetTiles() const
+    {
+        return Tiles;
+    }
+
+    FORCEINLINE bool IsValidTile(const FIntPoint& Tile) const
+    {
+        return Tile.X >= 0 && Tile.X < GetTileCountX() && Tile.Y >= 0 && Tile.Y < GetTileCountY();
+    }
+
+    FORCEINLINE IAGGRenderBuffer* FindTile(const FIntPoint& Tile) const
+    {
+        const TUniquePtr<IAGGRenderBuffer>* TileBuffer = Tiles.Find(Tile);
+        return TileBuffer ? TileBuffer->Get() : nullptr;
+    }
+
+    // Returns the tile buffer, allocating and clearing it on first access
+    IAGGRenderBuffer* FindOrAddTile(const FIntPoint& Tile)
+    {
+        if (IAGGRenderBuffer* TileBuffer = FindTile(Tile))
+        {
+            return TileBuffer;
+        }
+
+        if (! IsValidTile(Tile))
+        {
+            return nullptr;
+        }
+
+        IAGGRenderBuffer* TileBuffer = CreateTileBuffer();
+        TileBuffer->Init(TileSize, TileSize, ClearVal);
+        Tiles.Emplace(Tile, TUniquePtr<IAGGRenderBuffer>(TileBuffer));
+
+        return TileBuffer;
+    }
+
+    FORCEINLINE bool ReleaseTile(const FIntPoint& Tile)
+    {
+        return Tiles.Remove(Tile) > 0;
+    }
+
+    // Reading unallocated tiles returns the clear value
+    uint8 GetByteAt(int32 X, int32 Y) const
+    {
+        if (X < 0 || X >= CanvasWidth || Y < 0 || Y >= CanvasHeight)
+        {
+            return 0;
+        }
+
+        const FIntPoint Tile(X/TileSize, Y/TileSize);
+
+        if (const IAGGRenderBuffer* TileBuffer = FindTile(Tile))
+        {
+            return TileBuffer->GetByteAt(X-Tile.X*TileSize, Y-Tile.Y*TileSize);
+        }
+
+        return ClearVal;
+    }
+
+protected:
+
+    FTileMap Tiles;
+    int32 CanvasWidth = 0;
+    int32 CanvasHeight = 0;
+    int32 TileSize = DefaultTileSize;
+    uint8 ClearVal = 0;
+
+    virtual IAGGRenderBuffer* CreateTileBuffer() const = 0;
+};
+
+template<class FPixFmtType>
+class AGGPLUGIN_API TAGGTiledBuffer : public IAGGTiledBuffer
+{
+public:
+
+    typedef FPixFmtType FPixFmt;
+
+protected:
+
+    virtual IAGGRenderBuffer* CreateTileBuffer() const override
+    {
+        return new TAGGRenderBuffer<FPixFmt>();
+    }
+};
+
+// Base renderer that distributes spans over canvas tiles. Implements the
+// subset of agg::renderer_base used by the solid scanline renderers, spans
+// crossing tile boundaries are split so tiles join without seams.
+
+template<class FPixFmtType>
+class TAGGTiledRendererBase
+{
+public:
+
+    typedef FPixFmtType pixfmt_type;
+    typedef typename FPixFmtType::color_type color_type;
+
+private:
+
+    typedef agg::renderer_base<FPixFmtType> FTileRenderer;
+
+    struct FTileTarget
+    {
+        IAGGRenderBuffer* Buffer;
+        FPixFmtType PixFmt;
+        FTileRenderer Renderer;
+
+        int32 DirtyMinX = MAX_int32;
+        int32 DirtyMinY = MAX_int32;
+        int32 DirtyMaxX = MIN_int32;
+        int32 DirtyMaxY = MIN_int32;
+
+        FTileTarget(IAGGRenderBuffer& InBuffer)
+            : Buffer(&InBuffer)
+            , PixFmt(InBuffer.GetAGGBuffer())
+        {
+            Renderer.attach(PixFmt);
+        }
+    };
+
+    IAGGTiledBuffer* Canvas = nullptr;
+
+    // Targets of the current tile row
+    TArray<TUniquePtr<FTileTarget>> RowTargets;
+    int32 RowTileY = INDEX_NONE;
+
+public:
+
+	TAGGTiledRendererBase() = default;
+
+	~TAGGTiledRendererBase()
+    {
+        Flush();
+    }
+
+    void Attach(IAGGTiledBuffer& InCanvas)
+    {
+        Flush();
+        Canvas = &InCanvas;
+        RowTargets.Reset();
+        RowTargets.SetNum(Canvas->GetTileCountX());
+        RowTileY = INDEX_NONE;
+    }
+
+    // Flushes rendered bounds to tile dirty rects
+    void Flush()
+    {
+        for (TUniquePtr<FTileTarget>& Target : RowTargets)
+        {
+            if (Target.IsValid())
+            {
+                if (Target->DirtyMinX <= Target->DirtyMaxX)
+                {
+                    Target->Buffer->AddDirtyRect(Target->DirtyMinX, Target->DirtyMinY, Target->DirtyMaxX, Target->DirtyMaxY);
+                }
+                Target.Reset();
+            }
+        }
+        RowTileY = INDEX_NONE;
+    }
+
+    FORCEINLINE int xmin() const { return 0; }
+    FORCEINLINE int ymin() const { return 0; }
+    FORCEINLINE int xmax() const { return Canvas ? Canvas->GetWidth()-1 : -1; }
+    FORCEINLINE int ymax() const { return Canvas ? Canvas->GetHeight()-1 : -1; }
+
+    void blend_hline(int x1, int y, int x2, const color_type& c, agg::cover_type cover)
+    {
+        if (x1 > x2) { int t = x2; x2 = x1; x1 = t; }
+        if (! ClipSpan(x1, y, x2) || c.a == 0)
+        {
+            return;
+        }
+
+        const int32 TileSize = Canvas->GetTileSize();
+
+        while (x1 <= x2)
+        {
+            const int32 TileX = x1 / TileSize;
+            const int32 TileEnd = FMath::Min(x2, (TileX+1)*TileSize-1);
+
+            if (FTileTarget* Target = GetTarget(TileX, y))
+            {
+                const int32 OffsetX = TileX*TileSize;
+                const int32 LocalY = y - RowTileY*TileSize;
+                Target->Renderer.blend_hline(x1-OffsetX, LocalY, TileEnd-OffsetX, c, cover);
+                AddTargetBounds(*Target, x1-OffsetX, TileEnd-OffsetX, LocalY);
+            }
+
+            x1 = TileEnd+1;
+        }
+    }
+
+    void blend_solid_hspan(int x, int y, int len, const color_type& c, const agg::cover_type* covers)
+    {
+        int x2 = x+len-1;
+        const int x1 = x;
+
+        if (! ClipSpan(x, y, x2))
+        {
+            return;
+        }
+
+        covers += x-x1;
+
+        const int32 TileSize = Canvas->GetTileSize();
+
+        while (x <= x2)
+        {
+            const int32 TileX = x / TileSize;
+            const int32 TileEnd = FMath::Min(x2, (TileX+1)*TileSize-1);
+            const int32 SpanLen = TileEnd-x+1;
+
+            if (FTileTarget* Target = GetTarget(TileX, y))
+            {
+                const int32 OffsetX = TileX*TileSize;
+                const int32 LocalY = y - RowTileY*TileSize;
+                Target->Renderer.blend_solid_hspan(x-OffsetX, LocalY, SpanLen, c, covers);
+                AddTargetBounds(*Target, x-OffsetX, TileEnd-OffsetX, LocalY);
+            }
+
+            covers += SpanLen;
+            x = TileEnd+1;
+        }
+    }
+
+private:
+
+    FORCEINLINE bool ClipSpan(int& x1, int y, int& x2) const
+    {
+        if (! Canvas || y < 0 || y >= Canvas->GetHeight())
+        {
+            return false;
+        }
+
+        x1 = FMath::Max(x1, 0);
+        x2 = FMath::Min(x2, Canvas->GetWidth()-1);
+
+        return x1 <= x2;
+    }
+
+    FTileTarget* GetTarget(int32 TileX, int32 y)
+    {
+        const int32 TileY = y / Canvas->GetTileSize();
+
+        if (TileY != RowTileY)
+        {
+            Flush();
+            RowTileY = TileY;
+        }
+
+        TUniquePtr<FTileTarget>& Target = RowTargets[TileX];
+
+        if (! Target.IsValid())
+        {
+            IAGGRenderBuffer* Buffer = Canvas->FindOrAddTile(FIntPoint(TileX, TileY));
+
+            if (! Buffer)
+            {
+                return nullptr;
+            }
+
+            Target = MakeUnique<FTileTarget>(*Buffer);
+        }
+
+        return Target.Get();
+    }
+
+    FORCEINLINE static void AddTargetBounds(FTileTarget& Target, int32 MinX, int32 MaxX, int32 Y)
+    {
+        Target.DirtyMinX = FMath::Min(Target.DirtyMinX, MinX);
+        Target.DirtyMaxX = FMath::Max(Target.DirtyMaxX, MaxX);
+        Target.DirtyMinY = FMath::Min(Target.DirtyMinY, Y);
+        Target.DirtyMaxY = FMath::Max(Target.DirtyMaxY, Y);
+    }
+};
+
+// Tiled Renderer
+
+class AGGPLUGIN_API IAGGTiledRenderer
+{
+public:
+
+	virtual ~IAGGTiledRenderer() = default;
+
+    virtual void Attach(IAGGTiledBuffer& Canvas) = 0;
+    virtual void Render(agg::path_storage& Path, FColor Color, EAGGScanline ScanlineType) = 0;
+};
+
+template<class FPixFmtType>
+class AGGPLUGIN_API TAGGTiledRenderer : public IAGGTiledRenderer
+{
+public:
+
+    typedef FPixFmtType FPixFmt;
+    typedef TAGGTiledRendererBase<FPixFmt> FBaseRenderer;
+
+    agg::rasterizer_scanline_aa<> Rasterizer;
+    agg::scanline_p8 ScanlineP8;
+    agg::scanline_u8 ScanlineU8;
+    agg::scanline_bin ScanlineBin;
+    FBaseRenderer BaseRenderer;
+
+    virtual void Attach(IAGGTiledBuffer& Canvas) override
+    {
+        BaseRenderer.Attach(Canvas);
+        Rasterizer.clip_box(0, 0, Canvas.GetWidth(), Canvas.GetHeight());
+    }
+
+    virtual void Render(agg::path_storage& Path, FColor InColor, EAGGScanline ScanlineType) override
+    {
+        const agg::rgba8 Color(InColor.R, InColor.G, InColor.B, InColor.A);
+
+        Rasterizer.reset();
+        Rasterizer.add_path(Path);
+
+        switch (ScanlineType)
+        {
+            case EAGGScanline::SL_Unknown:
+            case EAGGScanline::SL_P8:
+                agg::render_scanlines_aa_solid(Rasterizer, ScanlineP8, BaseRenderer, Color);
+                break;
+            case EAGGScanline::SL_U8:
+                agg::render_scanlines_aa_solid(Rasterizer, ScanlineU8, BaseRenderer, Color);
+                break;
+            case EAGGScanline::SL_Bin:
+                agg::render_scanlines_bin_solid(Rasterizer, ScanlineBin, BaseRenderer, Color);
+                break;
+        }
+
+        BaseRenderer.Flush();
+    }
+};
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreUObject.h"
+#include "UniquePtr.h"
+#include "Engine/Texture2D.h"
+
+#include "AGGTypes.h"
+#include "AGGTiledBuffer.h"
+#include "AGGPathController.h"
+#include "AGGTiledCanvas.generated.h"
+
+// Very large sparse canvas. Only tiles that have been rendered to allocate
+// memory, each tile is uploaded to its own texture.
+
+UCLASS(BlueprintType)
+class AGGPLUGIN_API UAGGTiledCanvas : public UObject
+{
+	GENERATED_BODY()
+
+    // Declared before the renderer so it is destroyed last
+    TUniquePtr<IAGGTiledBuffer> Canvas;
+    TUniquePtr<IAGGTiledRenderer> Renderer;
+
+    EAGGPixFmt PixFmt = EAGGPixFmt::PF_Unknown;
+
+	UPROPERTY(Transient)
+    TMap<FIntPoint, UTexture2D*> TileTextures;
+
+    template<class FPixFmt>
+    void CreateCanvasTyped()
+    {
+        Canvas = MakeUnique< TAGGTiledBuffer<FPixFmt> >();
+        Renderer = MakeUnique< TAGGTiledRenderer<FPixFmt> >();
+    }
+
+public:
+
+    // BEGIN UObject Interface
+
+    virtual void BeginDestroy() override
+    {
+        Reset();
+        Super::BeginDestroy();
+    }
+
+    // END UObject Interface
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Init(int32 Width, int32 Height, EAGGPixFmt InPixFmt, int32 TileSize = 256, uint8 ClearVal = 0)
+    {
+        Reset();
+
+        if (Width <= 0 || Height <= 0 || TileSize <= 1)
+        {
+            return;
+        }
+
+        switch (InPixFmt)
+        {
+            case EAGGPixFmt::PF_G8:          CreateCanvasTyped<FAGGPFG8>();          break;
+            case EAGGPixFmt::PF_BGRA32:      CreateCanvasTyped<FAGGPFBGRA32>();      break;
+            case EAGGPixFmt::PF_AlphaBlendR: CreateCanvasTyped<FAGGPFAlphaBlendR>(); break;
+            case EAGGPixFmt::PF_AlphaBlendG: CreateCanvasTyped<FAGGPFAlphaBlendG>(); break;
+            case EAGGPixFmt::PF_AlphaBlendB: CreateCanvasTyped<FAGGPFAlphaBlendB>(); break;
+            default: return;
+        }
+
+        PixFmt = InPixFmt;
+        Canvas->Init(Width, Height, TileSize, ClearVal);
+        Renderer->Attach(*Canvas);
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void Reset()
+    {
+        Renderer.Reset();
+        Canvas.Reset();
+        TileTextures.Empty();
+        PixFmt = EAGGPixFmt::PF_Unknown;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    bool IsValidCanvas() const
+    {
+        return Canvas.IsValid() && Canvas->IsValid();
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    EPixelFormat GetPixelFormat() const
+    {
+        return PixFmt == EAGGPixFmt::PF_G8 ? EPixelFormat::PF_G8 : EPixelFormat::PF_B8G8R8A8;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 GetTileSize() const
+    {
+        return IsValidCanvas() ? Canvas->GetTileSize() : 0;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    FIntPoint GetTileCount() const
+    {
+        return IsValidCanvas()
+            ? FIntPoint(Canvas->GetTileCountX(), Canvas->GetTileCountY())
+            : FIntPoint::ZeroValue;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    int32 GetAllocatedTileCount() const
+    {
+        return IsValidCanvas() ? Canvas->GetAllocatedTileCount() : 0;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    TArray<FIntPoint> GetAllocatedTiles() const
+    {
+        TArray<FIntPoint> Tiles;
+        if (IsValidCanvas())
+        {
+            Canvas->GetTiles().GetKeys(Tiles);
+        }
+        return Tiles;
+    }
+
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    uint8 GetByteAt(int32 X, int32 Y) const
+    {
+        return IsValidCanvas() ? Canvas->GetByteAt(X, Y) : 0;
+    }
+
+    // Renders the path in canvas coordinates, spans are split across tiles
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void RenderPath(UAGGPathController* Path, FColor Color, EAGGScanline ScanlineType = EAGGScanline::SL_P8)
+    {
+        if (IsValidCanvas() && IsValid(Path))
+        {
+            Renderer->Render(Path->GetRenderPath(), Color, ScanlineType);
+        }
+    }
+
+    // Releases tile storage and its texture, the tile reads as cleared
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    void ReleaseTile(FIntPoint Tile)
+    {
+        if (IsValidCanvas())
+        {
+            Canvas->ReleaseTile(Tile);
+            TileTextures.Remove(Tile);
+        }
+    }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="AGG")
+    UTexture2D* GetTileTexture(FIntPoint Tile) const
+    {
+        UTexture2D* const* Texture = TileTextures.Find(Tile);
+        return Texture ? *Texture : nullptr;
+    }
+
+    // Creates textures for new tiles and streams dirty regions of existing
+    // ones. Returns the tiles whose texture has been created or updated.
+    UFUNCTION(BlueprintCallable, Category="AGG")
+    TArray<FIntPoint> UpdateTileTextures(TextureFilter FilterType = TextureFilter::TF_Default, bool bSRGB = false)
+    {
+        TArray<FIntPoint> UpdatedTiles;
+
+        if (! IsValidCanvas())
+        {
+            return UpdatedTiles;
+        }
+
+        for (const IAGGTiledBuffer::FTileMap::ElementType& Tile : Canvas->GetTiles())
+        {
+            IAGGRenderBuffer& Buffer( *Tile.Value );
+
+            if (! Buffer.HasDirtyRect())
+            {
+                continue;
+            }
+
+            UTexture2D*& Texture( TileTextures.FindOrAdd(Tile.Key) );
+
+            if (! IsValid(Texture))
+            {
+                Texture = Buffer.CreateTransientTexture( GetPixelFormat() );
+                Texture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
+                Texture->SRGB = bSRGB ? 1 : 0;
+                Texture->Filter = FilterType;
+                Buffer.CopyTo(Texture);
+                Buffer.ClearDirtyRect();
+                Texture->UpdateResource();
+            }
+            else
+            {
+                Buffer.UpdateTextureRegion(Texture);
+            }
+
+            UpdatedTiles.Emplace(Tile.Key);
+        }
+
+        return UpdatedTiles;
+    }
+};
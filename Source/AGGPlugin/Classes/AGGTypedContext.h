@@ -46,7 +46,9 @@ protected:
 
     typedef FAGGBufferG8 FBuffer;
 
-    TSharedPtr<FBuffer> ContextBuffer;
+    // Front and back buffer, the back buffer is only allocated while
+    // the context is double buffered
+    TSharedPtr<FBuffer> ContextBuffers[2];
 
 public:
 
@@ -54,15 +56,21 @@ public:
     {
         UAGGContext::InitContext();
 
-        ContextBuffer = MakeShareable(new FBuffer());
+        ContextBuffers[0] = MakeShareable(new FBuffer());
+        ContextBuffers[1] = MakeShareable(new FBuffer());
     }
 
     virtual void ClearContext() override
     {
-        if (ContextBuffer.IsValid())
+        WaitAllRenderJobs();
+
+        for (TSharedPtr<FBuffer>& ContextBuffer : ContextBuffers)
         {
-            ContextBuffer->Reset();
-            ContextBuffer.Reset();
+            if (ContextBuffer.IsValid())
+            {
+                ContextBuffer->Reset();
+                ContextBuffer.Reset();
+            }
         }
 
         UAGGContext::ClearContext();
@@ -70,27 +78,42 @@ public:
 
     virtual void InitBuffer(int32 w, int32 h, int32 c, bool bSq) override
     {
-        check(ContextBuffer.IsValid());
+        check(ContextBuffers[0].IsValid() && ContextBuffers[1].IsValid());
+
+        WaitAllRenderJobs();
+        FrontBufferIndex.Set(0);
+        SwapDirtyRect.Reset();
+        ++BufferGeneration;
+
+        ContextBuffers[0]->Init(w, h, c, bSq);
 
-        ContextBuffer->Init(w, h, c, bSq);
+        if (bDoubleBuffered)
+        {
+            ContextBuffers[1]->Init(w, h, c, bSq);
+        }
+        else
+        {
+            ContextBuffers[1]->Reset();
+        }
     }
 
     virtual void ClearBuffer(uint8 ClearVal) override
     {
-        if (ContextBuffer.IsValid())
+        if (IAGGRenderBuffer* Buffer = GetRenderBuffer())
         {
-            ContextBuffer->Clear(0);
+            WaitAllRenderJobs();
+            Buffer->Clear(0);
         }
     }
 
-    FORCEINLINE virtual IAGGRenderBuffer* GetBuffer() override
+    FORCEINLINE virtual IAGGRenderBuffer* GetBufferAt(int32 Index) override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
-    FORCEINLINE virtual const IAGGRenderBuffer* GetBuffer() const override
+    FORCEINLINE virtual const IAGGRenderBuffer* GetBufferAt(int32 Index) const override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
     virtual EPixelFormat GetPixelFormat() const override
@@ -108,7 +131,9 @@ protected:
 
     typedef FAGGBufferBGRA32 FBuffer;
 
-    TSharedPtr<FBuffer> ContextBuffer;
+    // Front and back buffer, the back buffer is only allocated while
+    // the context is double buffered
+    TSharedPtr<FBuffer> ContextBuffers[2];
 
 public:
 
@@ -116,15 +141,21 @@ public:
     {
         UAGGContext::InitContext();
 
-        ContextBuffer = MakeShareable(new FBuffer());
+        ContextBuffers[0] = MakeShareable(new FBuffer());
+        ContextBuffers[1] = MakeShareable(new FBuffer());
     }
 
     virtual void ClearContext() override
     {
-        if (ContextBuffer.IsValid())
+        WaitAllRenderJobs();
+
+        for (TSharedPtr<FBuffer>& ContextBuffer : ContextBuffers)
         {
-            ContextBuffer->Reset();
-            ContextBuffer.Reset();
+            if (ContextBuffer.IsValid())
+            {
+                ContextBuffer->Reset();
+                ContextBuffer.Reset();
+            }
         }
 
         UAGGContext::ClearContext();
@@ -132,27 +163,42 @@ public:
 
     virtual void InitBuffer(int32 w, int32 h, int32 c, bool bSq) override
     {
-        check(ContextBuffer.IsValid());
+        check(ContextBuffers[0].IsValid() && ContextBuffers[1].IsValid());
+
+        WaitAllRenderJobs();
+        FrontBufferIndex.Set(0);
+        SwapDirtyRect.Reset();
+        ++BufferGeneration;
 
-        ContextBuffer->Init(w, h, c, bSq);
+        ContextBuffers[0]->Init(w, h, c, bSq);
+
+        if (bDoubleBuffered)
+        {
+            ContextBuffers[1]->Init(w, h, c, bSq);
+        }
+        else
+        {
+            ContextBuffers[1]->Reset();
+        }
     }
 
     virtual void ClearBuffer(uint8 ClearVal) override
     {
-        if (ContextBuffer.IsValid())
+        if (IAGGRenderBuffer* Buffer = GetRenderBuffer())
         {
-            ContextBuffer->Clear(0);
+            WaitAllRenderJobs();
+            Buffer->Clear(0);
         }
     }
 
-    FORCEINLINE virtual IAGGRenderBuffer* GetBuffer() override
+    FORCEINLINE virtual IAGGRenderBuffer* GetBufferAt(int32 Index) override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
-    FORCEINLINE virtual const IAGGRenderBuffer* GetBuffer() const override
+    FORCEINLINE virtual const IAGGRenderBuffer* GetBufferAt(int32 Index) const override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
     virtual EPixelFormat GetPixelFormat() const override
@@ -170,7 +216,9 @@ protected:
 
     typedef FAGGBufferPlainBGRA32 FBuffer;
 
-    TSharedPtr<FBuffer> ContextBuffer;
+    // Front and back buffer, the back buffer is only allocated while
+    // the context is double buffered
+    TSharedPtr<FBuffer> ContextBuffers[2];
 
 public:
 
@@ -178,15 +226,21 @@ public:
     {
         UAGGContext::InitContext();
 
-        ContextBuffer = MakeShareable(new FBuffer());
+        ContextBuffers[0] = MakeShareable(new FBuffer());
+        ContextBuffers[1] = MakeShareable(new FBuffer());
     }
 
     virtual void ClearContext() override
     {
-        if (ContextBuffer.IsValid())
+        WaitAllRenderJobs();
+
+        for (TSharedPtr<FBuffer>& ContextBuffer : ContextBuffers)
         {
-            ContextBuffer->Reset();
-            ContextBuffer.Reset();
+            if (ContextBuffer.IsValid())
+            {
+                ContextBuffer->Reset();
+                ContextBuffer.Reset();
+            }
         }
 
         UAGGContext::ClearContext();
@@ -194,27 +248,42 @@ public:
 
     virtual void InitBuffer(int32 w, int32 h, int32 c, bool bSq) override
     {
-        check(ContextBuffer.IsValid());
+        check(ContextBuffers[0].IsValid() && ContextBuffers[1].IsValid());
+
+        WaitAllRenderJobs();
+        FrontBufferIndex.Set(0);
+        SwapDirtyRect.Reset();
+        ++BufferGeneration;
 
-        ContextBuffer->Init(w, h, c, bSq);
+        ContextBuffers[0]->Init(w, h, c, bSq);
+
+        if (bDoubleBuffered)
+        {
+            ContextBuffers[1]->Init(w, h, c, bSq);
+        }
+        else
+        {
+            ContextBuffers[1]->Reset();
+        }
     }
 
     virtual void ClearBuffer(uint8 ClearVal) override
     {
-        if (ContextBuffer.IsValid())
+        if (IAGGRenderBuffer* Buffer = GetRenderBuffer())
         {
-            ContextBuffer->Clear(0);
+            WaitAllRenderJobs();
+            Buffer->Clear(0);
         }
     }
 
-    FORCEINLINE virtual IAGGRenderBuffer* GetBuffer() override
+    FORCEINLINE virtual IAGGRenderBuffer* GetBufferAt(int32 Index) override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
-    FORCEINLINE virtual const IAGGRenderBuffer* GetBuffer() const override
+    FORCEINLINE virtual const IAGGRenderBuffer* GetBufferAt(int32 Index) const override
     {
-        return ContextBuffer.Get();
+        return ContextBuffers[Index].Get();
     }
 
     virtual EPixelFormat GetPixelFormat() const override
@@ -71,6 +71,15 @@ enum class EAGGOutlineAALineJoin : uint8
     OUTLINE_MITER_ACCURATE_JOIN
 };
 
+UENUM(BlueprintType)
+enum class EAGGIntegerPathFormat : uint8
+{
+    // 16-bit pixel snapped coordinates, +-16383 pixels
+    IPF_Int16,
+    // 32-bit coordinates in 1/256 subpixels, +-4194303 pixels
+    IPF_Int32
+};
+
 USTRUCT(BlueprintType)
 struct FAGGOutlineAALineProfile
 {
@@ -89,6 +98,78 @@ struct FAGGOutlineAALineProfile
     bool bRoundCap = false;
 };
 
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGRendererStorageStats
+{
+    GENERATED_BODY()
+
+    // Number of rendered paths
+    UPROPERTY(BlueprintReadOnly)
+    int32 RenderCount = 0;
+
+    // Number of AGG storage allocations made by renders, including banded
+    // render workers, stays constant once rendering reaches steady state
+    UPROPERTY(BlueprintReadOnly)
+    int32 AllocationCount = 0;
+
+    // Number of renders that allocated
+    UPROPERTY(BlueprintReadOnly)
+    int32 AllocatingRenderCount = 0;
+
+    // High-water mark of rasterizer cells
+    UPROPERTY(BlueprintReadOnly)
+    int32 MaxCells = 0;
+
+    // High-water mark of rasterized rows
+    UPROPERTY(BlueprintReadOnly)
+    int32 MaxRows = 0;
+
+    // High-water mark of scanline span width
+    UPROPERTY(BlueprintReadOnly)
+    int32 MaxSpanWidth = 0;
+};
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGRendererCellStats
+{
+    GENERATED_BODY()
+
+    // Largest cell count of a single sweep in the last render call. Draw
+    // list replays accumulate statistics over all replayed commands.
+    UPROPERTY(BlueprintReadOnly)
+    int32 Cells = 0;
+
+    // Cell blocks allocated for the largest sweep
+    UPROPERTY(BlueprintReadOnly)
+    int32 Blocks = 0;
+
+    // Number of clip bands the last render was split into
+    UPROPERTY(BlueprintReadOnly)
+    int32 Bands = 0;
+
+    // Whether the render exceeded the cell budget and was subdivided
+    UPROPERTY(BlueprintReadOnly)
+    bool bSubdivided = false;
+
+    // Whether a sweep still reached the rasterizer cell limit and lost cells
+    UPROPERTY(BlueprintReadOnly)
+    bool bTruncated = false;
+};
+
+USTRUCT(BlueprintType)
+struct AGGPLUGIN_API FAGGRenderJobHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 JobId = INDEX_NONE;
+
+    FORCEINLINE bool IsValid() const
+    {
+        return JobId != INDEX_NONE;
+    }
+};
+
 class FAGGTypeUtility
 {
 public:
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "AGGBufferStorage.h"
+#include "ScopeLock.h"
+
+FAGGBufferPool& FAGGBufferPool::Get()
+{
+    static FAGGBufferPool Pool;
+    return Pool;
+}
+
+FAGGBufferPool::~FAGGBufferPool()
+{
+    Trim();
+}
+
+uint8* FAGGBufferPool::Allocate(SIZE_T Size, SIZE_T& OutCapacity)
+{
+    const SIZE_T Capacity = GetCapacity(Size);
+    const SIZE_T MaxCapacity = Capacity + Capacity/MaxSlack;
+
+    {
+        FScopeLock ScopeLock(&PoolLock);
+
+        // Find the smallest pooled block that fits within the slack
+
+        TArray<uint8*>* BestBucket = nullptr;
+        SIZE_T BestCapacity = 0;
+
+        for (TPair<SIZE_T, TArray<uint8*>>& Bucket : Buckets)
+        {
+            if (Bucket.Key >= Capacity && Bucket.Key <= MaxCapacity && Bucket.Value.Num() > 0)
+            {
+                if (! BestBucket || Bucket.Key < BestCapacity)
+                {
+                    BestBucket = &Bucket.Value;
+                    BestCapacity = Bucket.Key;
+                }
+            }
+        }
+
+        if (BestBucket)
+        {
+            uint8* Data = BestBucket->Pop(false);
+
+            if (BestBucket->Num() == 0)
+            {
+                Buckets.Remove(BestCapacity);
+            }
+
+            PooledBytes -= BestCapacity;
+            OutCapacity = BestCapacity;
+            return Data;
+        }
+    }
+
+    OutCapacity = Capacity;
+
+    return static_cast<uint8*>(FMemory::Malloc(Capacity, Alignment));
+}
+
+void FAGGBufferPool::Release(uint8* Data, SIZE_T Capacity)
+{
+    if (! Data)
+    {
+        return;
+    }
+
+    {
+        FScopeLock ScopeLock(&PoolLock);
+
+        if (PooledBytes+Capacity <= MaxPooledBytes)
+        {
+            Buckets.FindOrAdd(Capacity).Emplace(Data);
+            PooledBytes += Capacity;
+            return;
+        }
+    }
+
+    FMemory::Free(Data);
+}
+
+void FAGGBufferPool::Trim()
+{
+    FScopeLock ScopeLock(&PoolLock);
+
+    for (TPair<SIZE_T, TArray<uint8*>>& Bucket : Buckets)
+    {
+        for (uint8* Data : Bucket.Value)
+        {
+            FMemory::Free(Data);
+        }
+    }
+
+    Buckets.Empty();
+    PooledBytes = 0;
+}
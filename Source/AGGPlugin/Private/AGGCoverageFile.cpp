@@ -0,0 +1,308 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "AGGCoverageFile.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "AGGLogs.h"
+
+static_assert(sizeof(FAGGCoverageFile::FHeader) == 16, "Unexpected coverage file header size");
+static_assert(sizeof(FAGGCoverageFile::FEntry) == 48, "Unexpected coverage file entry size");
+
+FAGGCoverageFile::~FAGGCoverageFile()
+{
+    // Region has to be released before its file handle
+    delete MappedRegion;
+    delete MappedHandle;
+}
+
+bool FAGGCoverageFile::Save(const FString& Filename, const FAGGShapeCache& Cache)
+{
+    TArray<const TPair<FAGGShapeCache::FKey, FAGGShapeCache::FCoveragePtr>*> SavedEntries;
+    SavedEntries.Reserve(Cache.Num());
+
+    for (const TPair<FAGGShapeCache::FKey, FAGGShapeCache::FCoveragePtr>& Entry : Cache.GetEntries())
+    {
+        if (Entry.Value.IsValid() && ! Entry.Value->IsEmpty())
+        {
+            SavedEntries.Emplace(&Entry);
+        }
+    }
+
+    const int64 TableSize = sizeof(FHeader) + SavedEntries.Num()*sizeof(FEntry);
+    int64 FileSize = Align(TableSize, DataAlignment);
+
+    for (const TPair<FAGGShapeCache::FKey, FAGGShapeCache::FCoveragePtr>* Entry : SavedEntries)
+    {
+        FileSize += Align(Entry->Value->GetDataSize(), DataAlignment);
+    }
+
+    TArray<uint8> FileData;
+    FileData.SetNumZeroed(FileSize);
+
+    FHeader* Header = reinterpret_cast<FHeader*>(FileData.GetData());
+    Header->Magic = FileMagic;
+    Header->Version = FileVersion;
+    Header->EntryCount = SavedEntries.Num();
+    Header->Flags = 0;
+
+    FEntry* Entries = reinterpret_cast<FEntry*>(FileData.GetData() + sizeof(FHeader));
+    int64 DataOffset = Align(TableSize, DataAlignment);
+
+    for (int32 i=0; i<SavedEntries.Num(); ++i)
+    {
+        const FAGGShapeCache::FKey& Key( SavedEntries[i]->Key );
+        const FAGGCoverage& Coverage( *SavedEntries[i]->Value );
+        const FIntRect& Bounds( Coverage.GetBounds() );
+
+        FEntry& Entry( Entries[i] );
+        Entry.KeyHash = Key.Hash;
+        Entry.KeyNumVertices = Key.NumVertices;
+        Entry.MinX = Bounds.Min.X;
+        Entry.MinY = Bounds.Min.Y;
+        Entry.MaxX = Bounds.Max.X;
+        Entry.MaxY = Bounds.Max.Y;
+        Entry.KeyCrc = Key.Crc;
+        Entry.DataOffset = DataOffset;
+        Entry.DataSize = Coverage.GetDataSize();
+
+        FMemory::Memcpy(FileData.GetData()+DataOffset, Coverage.GetData(), Coverage.GetDataSize());
+        DataOffset += Align(Coverage.GetDataSize(), DataAlignment);
+    }
+
+    return FFileHelper::SaveArrayToFile(FileData, *Filename);
+}
+
+FAGGCoverageFile::FFilePtr FAGGCoverageFile::Load(const FString& Filename)
+{
+    FFilePtr File( MakeShareable(new FAGGCoverageFile()) );
+
+    IPlatformFile& PlatformFile( FPlatformFileManager::Get().GetPlatformFile() );
+
+    File->MappedHandle = PlatformFile.OpenMapped(*Filename);
+
+    if (File->MappedHandle)
+    {
+        File->MappedRegion = File->MappedHandle->MapRegion();
+    }
+
+    bool bParsed = false;
+
+    if (File->MappedRegion)
+    {
+        bParsed = File->Parse(File->MappedRegion->GetMappedPtr(), File->MappedRegion->GetMappedSize());
+    }
+    else
+    {
+        // Memory mapping not supported, read the whole file instead
+        if (FFileHelper::LoadFileToArray(File->FileData, *Filename))
+        {
+            bParsed = File->Parse(File->FileData.GetData(), File->FileData.Num());
+        }
+    }
+
+    if (! bParsed)
+    {
+        UE_LOG(LogAGG,Warning, TEXT("FAGGCoverageFile::Load() FAILED TO LOAD '%s'"), *Filename);
+        return FFilePtr();
+    }
+
+    return File;
+}
+
+bool FAGGCoverageFile::Parse(const uint8* InData, int64 InDataSize)
+{
+    if (! InData || InDataSize < int64(sizeof(FHeader)))
+    {
+        return false;
+    }
+
+    const FHeader* Header = reinterpret_cast<const FHeader*>(InData);
+
+    if (Header->Magic != FileMagic || Header->Version != FileVersion)
+    {
+        return false;
+    }
+
+    const int64 TableSize = sizeof(FHeader) + int64(Header->EntryCount)*sizeof(FEntry);
+
+    if (TableSize > InDataSize)
+    {
+        return false;
+    }
+
+    const FEntry* InEntries = reinterpret_cast<const FEntry*>(InData + sizeof(FHeader));
+
+    for (uint32 i=0; i<Header->EntryCount; ++i)
+    {
+        const FEntry& Entry( InEntries[i] );
+
+        if (Entry.DataOffset > uint64(InDataSize) || Entry.DataSize > uint64(InDataSize)-Entry.DataOffset || Entry.DataSize > MAX_int32)
+        {
+            return false;
+        }
+
+        if (! ValidateCoverage(InData + Entry.DataOffset, Entry.DataSize))
+        {
+            return false;
+        }
+    }
+
+    Data = InData;
+    DataSize = InDataSize;
+    Entries = InEntries;
+    EntryCount = Header->EntryCount;
+
+    Coverages.SetNum(EntryCount);
+
+    for (int32 i=0; i<EntryCount; ++i)
+    {
+        const FEntry& Entry( Entries[i] );
+
+        Coverages[i].SetView(
+            Data + Entry.DataOffset,
+            static_cast<int32>(Entry.DataSize),
+            FIntRect(Entry.MinX, Entry.MinY, Entry.MaxX, Entry.MaxY)
+            );
+    }
+
+    return true;
+}
+
+bool FAGGCoverageFile::ValidateCoverage(const uint8* InData, int64 InDataSize)
+{
+    // Layout written by agg::scanline_storage_aa8::serialize()
+    auto ReadInt32 = [](const uint8* Ptr)
+    {
+        int32 Value;
+        FMemory::Memcpy(&Value, Ptr, sizeof(int32));
+        return Value;
+    };
+
+    // Empty coverage is never replayed
+    if (InDataSize == 0)
+    {
+        return true;
+    }
+
+    // Bounds
+    if (InDataSize < 4*int64(sizeof(int32)))
+    {
+        return false;
+    }
+
+    const uint8* Ptr = InData + 4*sizeof(int32);
+    const uint8* End = InData + InDataSize;
+
+    while (Ptr < End)
+    {
+        // Scanline size, y and span count
+        if (End-Ptr < 3*int64(sizeof(int32)))
+        {
+            return false;
+        }
+
+        const int32 ScanlineSize = ReadInt32(Ptr);
+        const int32 NumSpans = ReadInt32(Ptr + 2*sizeof(int32));
+
+        if (ScanlineSize < 3*int32(sizeof(int32)) || ScanlineSize > End-Ptr || NumSpans <= 0)
+        {
+            return false;
+        }
+
+        const uint8* SpanPtr = Ptr + 3*sizeof(int32);
+        const uint8* ScanlineEnd = Ptr + ScanlineSize;
+
+        for (int32 i=0; i<NumSpans; ++i)
+        {
+            // Span x and length
+            if (ScanlineEnd-SpanPtr < 2*int64(sizeof(int32)))
+            {
+                return false;
+            }
+
+            const int32 Len = ReadInt32(SpanPtr + sizeof(int32));
+
+            if (Len == 0 || Len == MIN_int32)
+            {
+                return false;
+            }
+
+            // Solid spans store a single cover
+            const int64 CoverSize = Len < 0 ? 1 : Len;
+            SpanPtr += 2*sizeof(int32);
+
+            if (CoverSize > ScanlineEnd-SpanPtr)
+            {
+                return false;
+            }
+
+            SpanPtr += CoverSize;
+        }
+
+        if (SpanPtr != ScanlineEnd)
+        {
+            return false;
+        }
+
+        Ptr = ScanlineEnd;
+    }
+
+    return true;
+}
+
+FAGGShapeCache::FKey FAGGCoverageFile::GetKey(int32 Index) const
+{
+    check(Index >= 0 && Index < EntryCount);
+
+    FAGGShapeCache::FKey Key;
+    Key.Hash = Entries[Index].KeyHash;
+    Key.Crc = Entries[Index].KeyCrc;
+    Key.NumVertices = Entries[Index].KeyNumVertices;
+
+    return Key;
+}
+
+FAGGShapeCache::FCoveragePtr FAGGCoverageFile::GetCoverage(int32 Index) const
+{
+    check(Index >= 0 && Index < EntryCount);
+
+    // Aliases the file reference count, no per entry allocation
+    const TSharedPtr<const FAGGCoverageFile, ESPMode::ThreadSafe> File( AsShared() );
+    return FAGGShapeCache::FCoveragePtr(File, &Coverages[Index]);
+}
+
+void FAGGCoverageFile::AddToCache(FAGGShapeCache& Cache) const
+{
+    Cache.Reserve(EntryCount);
+
+    for (int32 i=0; i<EntryCount; ++i)
+    {
+        Cache.Add(GetKey(i), GetCoverage(i));
+    }
+}
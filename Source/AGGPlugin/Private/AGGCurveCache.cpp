@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "AGGCurveCache.h"
+#include "ScopeLock.h"
+
+FAGGCurveCache& FAGGCurveCache::Get()
+{
+    static FAGGCurveCache Cache;
+    return Cache;
+}
+
+FAGGCurveCache::FSegmentRef FAGGCurveCache::Find(const FKey& Key)
+{
+    FScopeLock ScopeLock(&CacheLock);
+
+    if (const FSegmentRef* Segment = Current.Find(Key))
+    {
+        return *Segment;
+    }
+
+    // Promote entries still in use from the previous generation
+
+    FSegmentRef Segment;
+
+    if (Previous.RemoveAndCopyValue(Key, Segment))
+    {
+        Current.Emplace(Key, Segment);
+    }
+
+    return Segment;
+}
+
+void FAGGCurveCache::Add(const FKey& Key, const FSegmentRef& Segment)
+{
+    FScopeLock ScopeLock(&CacheLock);
+
+    if (Current.Num() >= MaxEntries)
+    {
+        Previous = MoveTemp(Current);
+        Current.Reset();
+    }
+
+    Current.Emplace(Key, Segment);
+}
+
+void FAGGCurveCache::Empty()
+{
+    FScopeLock ScopeLock(&CacheLock);
+
+    Current.Empty();
+    Previous.Empty();
+}
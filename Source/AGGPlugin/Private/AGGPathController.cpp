@@ -40,7 +40,7 @@ void UAGGPathController::ConvertCurvesToPoints(TArray<FVector2D>& OutPoints, con
 
     typedef FAGGPathController FAGGPath;
 
-    FAGGPath Path;
+    FAGGScratchPath Path;
 
     if (bCircular)
     {
@@ -49,16 +49,16 @@ void UAGGPathController::ConvertCurvesToPoints(TArray<FVector2D>& OutPoints, con
         const FVector2D& P1(InPoints[1]);
         const FVector2D PN0(FAGGPath::GetMidPoint(PN, P0));
         const FVector2D P01(FAGGPath::GetMidPoint(P0, P1));
-        Path.MoveTo(PN0);
-        Path.Curve3(P0, P01);
+        Path->move_to(PN0.X, PN0.Y);
+        Path->curve3(P0.X, P0.Y, P01.X, P01.Y);
     }
     else
     {
         const FVector2D& P0(InPoints[0]);
         const FVector2D& P1(InPoints[1]);
         const FVector2D P01(FAGGPath::GetMidPoint(P0, P1));
-        Path.MoveTo(P0);
-        Path.LineTo(P01);
+        Path->move_to(P0.X, P0.Y);
+        Path->line_to(P01.X, P01.Y);
     }
 
     for (int32 i=1; i<PointCount; ++i)
@@ -66,10 +66,24 @@ void UAGGPathController::ConvertCurvesToPoints(TArray<FVector2D>& OutPoints, con
         const FVector2D& P0(InPoints[i]);
         const FVector2D& P1(InPoints[(i+1)%PointCount]);
         const FVector2D P01(FAGGPath::GetMidPoint(P0, P1));
-        Path.Curve3(P0, P01);
+        Path->curve3(P0.X, P0.Y, P01.X, P01.Y);
     }
 
-    Path.PathAsCurve(CurveSettings);
-    Path.ApplyConversion();
-    Path.ToArray(OutPoints);
+    // Stream flattened vertices directly instead of converting in place
+
+    agg::conv_curve<agg::path_storage> Curve(*Path);
+    FAGGPathConversion::ApplyCurveSettings(Curve, CurveSettings);
+
+    double x, y;
+    unsigned cmd;
+
+    Curve.rewind(0);
+
+    while (! agg::is_stop(cmd = Curve.vertex(&x, &y)))
+    {
+        if (agg::is_vertex(cmd))
+        {
+            OutPoints.Emplace(x, y);
+        }
+    }
 }
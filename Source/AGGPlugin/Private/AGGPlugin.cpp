@@ -26,15 +26,26 @@
 //
 
 #include "AGGPlugin.h"
+#include "AGGBufferStorage.h"
+#include "AGGCurveCache.h"
+#include "AGGFrameArena.h"
+#include "Misc/CoreDelegates.h"
 
 #define LOCTEXT_NAMESPACE "FAGGPlugin"
 
 void FAGGPlugin::StartupModule()
 {
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FAGGFrameArena::OnEndFrame);
+    MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddRaw(&FAGGBufferPool::Get(), &FAGGBufferPool::Trim);
 }
 
 void FAGGPlugin::ShutdownModule()
 {
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+    FAGGFrameArena::Get().Trim();
+    FAGGCurveCache::Get().Empty();
+    FAGGBufferPool::Get().Trim();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -84,6 +84,8 @@ void UAGGUtilityLibrary::GenerateDepthMap(TArray<float>& DepthMap, UAGGContext*
         return;
     }
 
+    Context->WaitAllRenderJobs();
+
     IAGGRenderBuffer* Buffer = Context->GetBuffer();
     const int32 DimX = Buffer->GetWidth();
     const int32 DimY = Buffer->GetHeight();
@@ -95,7 +97,9 @@ void UAGGUtilityLibrary::GenerateDepthMap(TArray<float>& DepthMap, UAGGContext*
         return;
     }
 
-    TArray<uint8>& BufferData(Buffer->GetByteBuffer());
+    // Only padded buffers are copied
+    TArray<uint8> ByteBuffer;
+    const uint8* BufferData = Buffer->GetPackedView(ByteBuffer).GetData();
 
     // Iteration queue
     TQueue<int32> tvQ;
@@ -322,6 +326,8 @@ UTexture2D* UAGGUtilityLibrary::CreateDepthMapTexture(UAGGContext* Context, UCur
         return Texture;
     }
 
+    Context->WaitAllRenderJobs();
+
     IAGGRenderBuffer* Buffer = Context->GetBuffer();
     const int32 DimX = Buffer->GetWidth();
     const int32 DimY = Buffer->GetHeight();
@@ -36,4 +36,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle MemoryTrimHandle;
 };
@@ -32,10 +32,19 @@ namespace agg
     // won't be called in this case, however everything will remain working. 
     // The second argument of deallocate() is the size of the allocated 
     // block. You can use this information if you wish.
+    //-----------------------------------------------------pod_allocation_count
+    // Number of pod_allocator and obj_allocator allocations made by the
+    // calling thread, used for allocation statistics.
+    inline unsigned& pod_allocation_count()
+    {
+        static thread_local unsigned count = 0;
+        return count;
+    }
+
     //------------------------------------------------------------pod_allocator
     template<class T> struct pod_allocator
     {
-        static T*   allocate(unsigned num)       { return new T [num]; }
+        static T*   allocate(unsigned num)       { ++pod_allocation_count(); return new T [num]; }
         static void deallocate(T* ptr, unsigned) { delete [] ptr;      }
     };
 
@@ -49,7 +58,7 @@ namespace agg
     //------------------------------------------------------------obj_allocator
     template<class T> struct obj_allocator
     {
-        static T*   allocate()         { return new T; }
+        static T*   allocate()         { ++pod_allocation_count(); return new T; }
         static void deallocate(T* ptr) { delete ptr;   }
     };
 }
@@ -50,6 +50,17 @@ namespace agg
 
         void remove_all();
         void free_all();
+        void reserve(unsigned num_vertices);
+
+        // Exchanges the vertex blocks of two storages without copying
+        void swap(self_type& v)
+        {
+            agg::swap_elements(m_total_vertices, v.m_total_vertices);
+            agg::swap_elements(m_total_blocks,   v.m_total_blocks);
+            agg::swap_elements(m_max_blocks,     v.m_max_blocks);
+            agg::swap_elements(m_coord_blocks,   v.m_coord_blocks);
+            agg::swap_elements(m_cmd_blocks,     v.m_cmd_blocks);
+        }
 
         void add_vertex(double x, double y, unsigned cmd);
         void modify_vertex(unsigned idx, double x, double y);
@@ -68,6 +79,11 @@ namespace agg
         unsigned vertex(unsigned idx, double* x, double* y) const;
         unsigned command(unsigned idx) const;
 
+        // Interleaved xy coordinates and commands of block nb
+        const T*     block_coords(unsigned nb)   const { return m_coord_blocks[nb]; }
+        const int8u* block_commands(unsigned nb) const { return m_cmd_blocks[nb]; }
+        T*           block_coords(unsigned nb)         { return m_coord_blocks[nb]; }
+
     private:
         void   allocate_block(unsigned nb);
         int8u* storage_ptrs(T** xy_ptr);
@@ -332,6 +348,43 @@ namespace agg
         m_total_blocks++;
     }
 
+    //------------------------------------------------------------------------
+    template<class T, unsigned S, unsigned P>
+    void vertex_block_storage<T,S,P>::reserve(unsigned num_vertices)
+    {
+        unsigned nb = (num_vertices + block_mask) >> block_shift;
+        if(nb > m_max_blocks)
+        {
+            unsigned max_blocks = (nb + block_pool - 1) / block_pool * block_pool;
+
+            T** new_coords = 
+                pod_allocator<T*>::allocate(max_blocks * 2);
+
+            unsigned char** new_cmds = 
+                (unsigned char**)(new_coords + max_blocks);
+
+            if(m_coord_blocks)
+            {
+                memcpy(new_coords, 
+                       m_coord_blocks, 
+                       m_max_blocks * sizeof(T*));
+
+                memcpy(new_cmds, 
+                       m_cmd_blocks, 
+                       m_max_blocks * sizeof(unsigned char*));
+
+                pod_allocator<T*>::deallocate(m_coord_blocks, m_max_blocks * 2);
+            }
+            m_coord_blocks = new_coords;
+            m_cmd_blocks   = new_cmds;
+            m_max_blocks   = max_blocks;
+        }
+        while(m_total_blocks < nb)
+        {
+            allocate_block(m_total_blocks);
+        }
+    }
+
     //------------------------------------------------------------------------
     template<class T, unsigned S, unsigned P>
     int8u* vertex_block_storage<T,S,P>::storage_ptrs(T** xy_ptr)
@@ -615,6 +668,8 @@ namespace agg
         path_base() : m_vertices(), m_iterator(0) {}
         void remove_all() { m_vertices.remove_all(); m_iterator = 0; }
         void free_all()   { m_vertices.free_all();   m_iterator = 0; }
+        void reserve(unsigned num_vertices) { m_vertices.reserve(num_vertices); }
+        void swap(self_type& ps) { m_vertices.swap(ps.m_vertices); m_iterator = 0; ps.m_iterator = 0; }
 
         // Make path functions
         //--------------------------------------------------------------------
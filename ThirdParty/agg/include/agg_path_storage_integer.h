@@ -114,6 +114,10 @@ namespace agg
         {
             return m_storage[idx].vertex(x, y);
         }
+        const vertex_integer_type& raw_vertex(unsigned idx) const
+        {
+            return m_storage[idx];
+        }
 
         //--------------------------------------------------------------------
         unsigned byte_size() const { return m_storage.size() * sizeof(vertex_integer_type); }
@@ -175,6 +175,7 @@ namespace agg
         int min_y() const { return m_outline.min_y(); }
         int max_x() const { return m_outline.max_x(); }
         int max_y() const { return m_outline.max_y(); }
+        unsigned total_cells() const { return m_outline.total_cells(); }
 
         //--------------------------------------------------------------------
         void sort();